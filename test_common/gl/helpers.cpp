@@ -2258,10 +2258,12 @@ void* CreateRandomData( ExplicitType type, size_t count, MTdata d )
             cl_half *p = (cl_half *)malloc(count * sizeof(cl_half));
             if(!p) return 0;
 
+            std::vector<float> values(count);
             for( size_t i = 0; i < count; i++ )
             {
-                p[ i ] = convert_float_to_half( get_random_float( 0.f, 1.f, d ) );
+                values[ i ] = get_random_float( 0.f, 1.f, d );
             }
+            convert_float_array_to_half(p, values.data(), count);
 
             return (void*)p;
         }
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "benchmarkHelpers.h"
+
+#include "errorHelpers.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+bool gBenchmark = false;
+cl_ulong gBenchmarkMaxSize = 0;
+cl_uint gBenchmarkSamples = 0;
+
+cl_ulong host_elapsed_ns(BenchmarkClock::time_point start,
+                         BenchmarkClock::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+        .count();
+}
+
+cl_int get_event_elapsed_ns(cl_event first, cl_event last, cl_ulong &ns)
+{
+    cl_ulong startTime, endTime;
+    cl_int error = clGetEventProfilingInfo(first, CL_PROFILING_COMMAND_START,
+                                           sizeof(startTime), &startTime, NULL);
+    test_error(error, "Unable to get the command start time");
+    error = clGetEventProfilingInfo(last, CL_PROFILING_COMMAND_END,
+                                    sizeof(endTime), &endTime, NULL);
+    test_error(error, "Unable to get the command end time");
+    ns = endTime > startTime ? endTime - startTime : 1;
+    return CL_SUCCESS;
+}
+
+int get_benchmark_sizes(cl_device_id device, size_t minSize, size_t reserve,
+                        std::vector<size_t> &sizes)
+{
+    cl_ulong maxAlloc, globalMem;
+    int error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                                sizeof(maxAlloc), &maxAlloc, NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE,
+                             sizeof(globalMem), &globalMem, NULL);
+    test_error(error, "Unable to get device memory sizes");
+
+    cl_ulong maxSize = std::min(maxAlloc, globalMem / 4);
+    maxSize = maxSize > reserve ? maxSize - reserve : 0;
+    if (gBenchmarkMaxSize) maxSize = std::min(maxSize, gBenchmarkMaxSize);
+    sizes.clear();
+    for (cl_ulong size = minSize; size <= maxSize; size *= 4)
+        sizes.push_back((size_t)size);
+    if (sizes.empty())
+    {
+        log_error("ERROR: benchmark allocations are limited to %" PRIu64
+                  " bytes, less than %zu\n",
+                  maxSize, minSize);
+        return -1;
+    }
+    return CL_SUCCESS;
+}
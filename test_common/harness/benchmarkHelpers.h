@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _benchmarkHelpers_h
+#define _benchmarkHelpers_h
+
+#include "compat.h"
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+#include <chrono>
+#include <vector>
+
+// Benchmarks only run with --benchmark and skip themselves otherwise. Each
+// prints a header line naming its fields and then one line per measurement,
+// all starting with the same upper case tag and with the fields separated by
+// single spaces, so the results can be extracted from the rest of the log.
+
+extern bool gBenchmark;
+// Largest allocation a benchmark uses, 0 for its own limit
+extern cl_ulong gBenchmarkMaxSize;
+// Timed samples per measurement, 0 for the benchmark's own default
+extern cl_uint gBenchmarkSamples;
+
+// Timed samples of a measurement that follow its untimed warm-up run, unless
+// the benchmark has a default of its own
+const int kBenchmarkSamples = 5;
+
+inline int benchmark_samples(int defaultSamples = kBenchmarkSamples)
+{
+    return gBenchmarkSamples ? (int)gBenchmarkSamples : defaultSamples;
+}
+
+typedef std::chrono::steady_clock BenchmarkClock;
+
+extern cl_ulong host_elapsed_ns(BenchmarkClock::time_point start,
+                                BenchmarkClock::time_point end);
+
+// Device time from the start of first to the end of last. Coarse device
+// timers can report 0 ns for short commands, which is counted as 1 ns so that
+// rates stay finite.
+extern cl_int get_event_elapsed_ns(cl_event first, cl_event last,
+                                   cl_ulong &ns);
+inline cl_int get_event_elapsed_ns(cl_event event, cl_ulong &ns)
+{
+    return get_event_elapsed_ns(event, event, ns);
+}
+
+// Sizes from minSize up to the largest allocation a benchmark should make,
+// each four times the last. The largest is limited to a quarter of the global
+// memory, to CL_DEVICE_MAX_MEM_ALLOC_SIZE less reserve bytes and to
+// --benchmark-max-size.
+extern int get_benchmark_sizes(cl_device_id device, size_t minSize,
+                               size_t reserve, std::vector<size_t> &sizes);
+
+// Nearest rank percentile p, from 0 to 100, of non-empty sorted samples
+template <typename T>
+T sorted_percentile(const std::vector<T> &sorted, double p)
+{
+    return sorted[(size_t)(p / 100.0 * (sorted.size() - 1) + 0.5)];
+}
+
+#endif // _benchmarkHelpers_h
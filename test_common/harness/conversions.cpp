@@ -23,6 +23,9 @@
 
 #include <CL/cl_half.h>
 
+#include <atomic>
+#include <vector>
+
 #if defined(__SSE__) || defined(_MSC_VER)
 #include <xmmintrin.h>
 #endif
@@ -1342,3 +1345,268 @@ size_t get_random_size_t(size_t low, size_t high, MTdata d)
 
     return (range) ? low + ((u.size - low) % range) : low;
 }
+
+#if (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+#include <immintrin.h>
+
+// The 8-wide F16C forms also need the OS to save AVX state.
+static bool host_half_conversions_supported()
+{
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+}
+
+// F16C rounds as told by its immediate operand, but flushes denormal inputs
+// to zero when MXCSR.DAZ is set.
+static bool host_half_environment_usable() { return !(_mm_getcsr() & 0x40); }
+
+static bool host_floats_to_halves_usable(cl_half_rounding_mode)
+{
+    return host_half_environment_usable();
+}
+
+static bool host_halves_to_floats_usable()
+{
+    return host_half_environment_usable();
+}
+
+template <int mode>
+__attribute__((target("avx,f16c"))) static void
+floats_to_halves_f16c(cl_half *out, const float *in, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm_storeu_si128((__m128i *)(out + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(in + i), mode));
+    for (; i < count; i++)
+        out[i] = (cl_half)_mm_extract_epi16(
+            _mm_cvtps_ph(_mm_set_ss(in[i]), mode), 0);
+}
+
+static bool host_floats_to_halves(cl_half *out, const float *in, size_t count,
+                                  cl_half_rounding_mode rounding)
+{
+    switch (rounding)
+    {
+        case CL_HALF_RTE:
+            floats_to_halves_f16c<_MM_FROUND_TO_NEAREST_INT>(out, in, count);
+            return true;
+        case CL_HALF_RTZ:
+            floats_to_halves_f16c<_MM_FROUND_TO_ZERO>(out, in, count);
+            return true;
+        case CL_HALF_RTP:
+            floats_to_halves_f16c<_MM_FROUND_TO_POS_INF>(out, in, count);
+            return true;
+        case CL_HALF_RTN:
+            floats_to_halves_f16c<_MM_FROUND_TO_NEG_INF>(out, in, count);
+            return true;
+    }
+    return false;
+}
+
+__attribute__((target("avx,f16c"))) static bool
+host_halves_to_floats(float *out, const cl_half *in, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i *)(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+    for (; i < count; i++)
+        out[i] = _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(in[i])));
+    return true;
+}
+
+#elif defined(__aarch64__) && defined(__ARM_NEON) && defined(__GNUC__)
+#include <arm_neon.h>
+
+static bool host_half_conversions_supported() { return true; }
+
+static uint64_t get_fpcr()
+{
+    uint64_t fpcr;
+    __asm__ volatile("mrs %0, fpcr" : "=r"(fpcr));
+    return fpcr;
+}
+
+// NEON converts with the rounding mode in FPCR, flushes denormal single
+// inputs to zero when FPCR.FZ is set and uses another half format when
+// FPCR.AHP is set.
+static bool host_floats_to_halves_usable(cl_half_rounding_mode rounding)
+{
+    uint64_t fpcr = get_fpcr();
+    if (fpcr & ((1 << 26) | (1 << 24))) return false;
+
+    switch ((fpcr >> 22) & 3)
+    {
+        case 0: return rounding == CL_HALF_RTE;
+        case 1: return rounding == CL_HALF_RTP;
+        case 2: return rounding == CL_HALF_RTN;
+        default: return rounding == CL_HALF_RTZ;
+    }
+}
+
+static bool host_halves_to_floats_usable() { return !(get_fpcr() & (1 << 26)); }
+
+static bool host_floats_to_halves(cl_half *out, const float *in, size_t count,
+                                  cl_half_rounding_mode)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1_u16(out + i,
+                 vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+    for (; i < count; i++)
+        out[i] = vget_lane_u16(
+            vreinterpret_u16_f16(vcvt_f16_f32(vdupq_n_f32(in[i]))), 0);
+    return true;
+}
+
+static bool host_halves_to_floats(float *out, const cl_half *in, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(out + i,
+                  vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+    for (; i < count; i++)
+        out[i] = vgetq_lane_f32(
+            vcvt_f32_f16(vreinterpret_f16_u16(vdup_n_u16(in[i]))), 0);
+    return true;
+}
+
+#else
+static bool host_half_conversions_supported() { return false; }
+
+static bool host_floats_to_halves_usable(cl_half_rounding_mode)
+{
+    return false;
+}
+
+static bool host_halves_to_floats_usable() { return false; }
+
+static bool host_floats_to_halves(cl_half *, const float *, size_t,
+                                  cl_half_rounding_mode)
+{
+    return false;
+}
+
+static bool host_halves_to_floats(float *, const cl_half *, size_t)
+{
+    return false;
+}
+#endif
+
+// Below this many elements converting one at a time is cheaper than checking
+// whether the host conversions can be used.
+static const size_t kMinHostConversionCount = 16;
+
+static bool is_half_nan_bits(cl_half h) { return (h & 0x7fff) > 0x7c00; }
+
+enum HostConversionStatus
+{
+    kHostConversionUnchecked = 0,
+    kHostConversionVerified,
+    kHostConversionRejected
+};
+
+// Check the host conversions against the software ones before trusting them:
+// every half, and floats with every exponent and a spread of mantissas. Only
+// called once the floating point environment is known to be usable, so the
+// result holds for the rest of the run.
+static HostConversionStatus
+check_host_floats_to_halves(cl_half_rounding_mode rounding)
+{
+    if (!host_half_conversions_supported()) return kHostConversionRejected;
+
+    std::vector<float> in(0x10000);
+    std::vector<cl_half> out(in.size());
+    for (cl_uint i = 0; i < in.size(); i++)
+    {
+        cl_uint bits = i * 0x10001U;
+        memcpy(&in[i], &bits, sizeof(bits));
+    }
+    if (!host_floats_to_halves(out.data(), in.data(), in.size(), rounding))
+        return kHostConversionRejected;
+
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        cl_half ref = cl_half_from_float(in[i], rounding);
+        if (out[i] != ref
+            && !(is_half_nan_bits(out[i]) && is_half_nan_bits(ref)))
+        {
+            log_info("Host float->half conversion disagrees with the "
+                     "reference for %a, not using it\n",
+                     in[i]);
+            return kHostConversionRejected;
+        }
+    }
+    return kHostConversionVerified;
+}
+
+static HostConversionStatus check_host_halves_to_floats()
+{
+    if (!host_half_conversions_supported()) return kHostConversionRejected;
+
+    std::vector<cl_half> in(0x10000);
+    std::vector<float> out(in.size());
+    for (cl_uint i = 0; i < in.size(); i++) in[i] = (cl_half)i;
+    if (!host_halves_to_floats(out.data(), in.data(), in.size()))
+        return kHostConversionRejected;
+
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        float ref = cl_half_to_float(in[i]);
+        if (memcmp(&out[i], &ref, sizeof(ref))
+            && !(isnan(out[i]) && isnan(ref)))
+        {
+            log_info("Host half->float conversion disagrees with the "
+                     "reference for 0x%4.4x, not using it\n",
+                     in[i]);
+            return kHostConversionRejected;
+        }
+    }
+    return kHostConversionVerified;
+}
+
+void convert_floats_to_halves(cl_half *out, const float *in, size_t count,
+                              cl_half_rounding_mode rounding)
+{
+    static std::atomic<int> status[4];
+
+    if (count >= kMinHostConversionCount
+        && (size_t)rounding < sizeof(status) / sizeof(status[0])
+        && host_floats_to_halves_usable(rounding))
+    {
+        int current = status[rounding].load(std::memory_order_relaxed);
+        if (current == kHostConversionUnchecked)
+        {
+            current = check_host_floats_to_halves(rounding);
+            status[rounding].store(current, std::memory_order_relaxed);
+        }
+        if (current == kHostConversionVerified
+            && host_floats_to_halves(out, in, count, rounding))
+            return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        out[i] = cl_half_from_float(in[i], rounding);
+}
+
+void convert_halves_to_floats(float *out, const cl_half *in, size_t count)
+{
+    static std::atomic<int> status;
+
+    if (count >= kMinHostConversionCount && host_halves_to_floats_usable())
+    {
+        int current = status.load(std::memory_order_relaxed);
+        if (current == kHostConversionUnchecked)
+        {
+            current = check_host_halves_to_floats();
+            status.store(current, std::memory_order_relaxed);
+        }
+        if (current == kHostConversionVerified
+            && host_halves_to_floats(out, in, count))
+            return;
+    }
+
+    for (size_t i = 0; i < count; i++) out[i] = cl_half_to_float(in[i]);
+}
@@ -93,6 +93,17 @@ extern int random_in_range(int minV, int maxV, MTdata d);
 
 size_t get_random_size_t(size_t low, size_t high, MTdata d);
 
+/* Convert arrays of floats to halves and back. The results are the same as
+ * calling cl_half_from_float / cl_half_to_float on every element (NaN
+ * payloads aside), but F16C or NEON instructions are used when the host has
+ * them and they have been checked to agree with those for the rounding mode
+ * in use. */
+extern void convert_floats_to_halves(cl_half *out, const float *in,
+                                     size_t count,
+                                     cl_half_rounding_mode rounding);
+extern void convert_halves_to_floats(float *out, const cl_half *in,
+                                     size_t count);
+
 // Note: though this takes a double, this is for use with single precision tests
 static inline int IsFloatSubnormal(float x)
 {
@@ -28,6 +28,9 @@
 #if !defined(_WIN32)
 #include <cmath>
 #endif
+#if defined(__SSE2__) || defined(_MSC_VER)
+#include <emmintrin.h>
+#endif
 
 RoundingMode gFloatToHalfRoundingMode = kDefaultRoundingMode;
 
@@ -340,15 +343,16 @@ int get_8_bit_image_format(cl_context context, cl_mem_object_type objType,
                            cl_mem_flags flags, size_t channelCount,
                            cl_image_format *outFormat)
 {
-    cl_image_format formatList[128];
-    unsigned int outFormatCount, i;
+    std::vector<cl_image_format> formatList;
+    size_t outFormatCount, i;
     int error;
 
 
     /* Make sure each image format is supported */
-    if ((error = clGetSupportedImageFormats(context, flags, objType, 128,
-                                            formatList, &outFormatCount)))
+    if ((error = get_supported_image_formats(context, flags, objType,
+                                             formatList)))
         return error;
+    outFormatCount = formatList.size();
 
 
     /* Look for one that is an 8-bit format */
@@ -377,15 +381,16 @@ int get_32_bit_image_format(cl_context context, cl_mem_object_type objType,
                             cl_mem_flags flags, size_t channelCount,
                             cl_image_format *outFormat)
 {
-    cl_image_format formatList[128];
-    unsigned int outFormatCount, i;
+    std::vector<cl_image_format> formatList;
+    size_t outFormatCount, i;
     int error;
 
 
     /* Make sure each image format is supported */
-    if ((error = clGetSupportedImageFormats(context, flags, objType, 128,
-                                            formatList, &outFormatCount)))
+    if ((error = get_supported_image_formats(context, flags, objType,
+                                             formatList)))
         return error;
+    outFormatCount = formatList.size();
 
     /* Look for one that is an 8-bit format */
     for (i = 0; i < outFormatCount; i++)
@@ -480,71 +485,161 @@ void print_first_pixel_difference_error(size_t where, const char *sourcePixel,
     }
 }
 
-size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
-                         const char *bPtr)
+bool get_undefined_bits_mask(const cl_image_format *format,
+                             cl_uchar mask[16])
 {
-    size_t pixel_size = get_pixel_size(imageInfo->format);
-    size_t column;
+    memset(mask, 0xff, 16);
 
-    for (column = 0; column < imageInfo->width; column++)
+    switch (format->image_channel_data_type)
     {
-        switch (imageInfo->format->image_channel_data_type)
-        {
-            // If the data type is 101010, then ignore bits 31 and 32 when
-            // comparing the row
-            case CL_UNORM_INT_101010: {
-                cl_uint aPixel = *(cl_uint *)aPtr;
-                cl_uint bPixel = *(cl_uint *)bPtr;
-                if ((aPixel & 0x3fffffff) != (bPixel & 0x3fffffff))
-                    return column;
-            }
-            break;
+        // If the data type is 101010, then bits 30 and 31 are undefined
+        case CL_UNORM_INT_101010:
+            for (int i = 3; i < 16; i += 4) mask[i] = 0x3f;
+            return true;
 
-            // If the data type is 555, ignore bit 15 when comparing the row
-            case CL_UNORM_SHORT_555: {
-                cl_ushort aPixel = *(cl_ushort *)aPtr;
-                cl_ushort bPixel = *(cl_ushort *)bPtr;
-                if ((aPixel & 0x7fff) != (bPixel & 0x7fff)) return column;
-            }
-            break;
+        // If the data type is 555, bit 15 is undefined
+        case CL_UNORM_SHORT_555:
+            for (int i = 1; i < 16; i += 2) mask[i] = 0x7f;
+            return true;
 
-            case CL_SNORM_INT8: {
-                cl_uchar aPixel = *(cl_uchar *)aPtr;
-                cl_uchar bPixel = *(cl_uchar *)bPtr;
-                // -1.0 is defined as 0x80 and 0x81
+        default: return false;
+    }
+}
+
+// Compares a single pixel, honouring undefined bits and the formats that have
+// more than one encoding for the same value.
+static bool pixels_match(const cl_image_format *format, const char *aPtr,
+                         const char *bPtr, size_t pixel_size)
+{
+    switch (format->image_channel_data_type)
+    {
+        case CL_UNORM_INT_101010: {
+            cl_uint aPixel = *(cl_uint *)aPtr;
+            cl_uint bPixel = *(cl_uint *)bPtr;
+            return (aPixel & 0x3fffffff) == (bPixel & 0x3fffffff);
+        }
+
+        case CL_UNORM_SHORT_555: {
+            cl_ushort aPixel = *(cl_ushort *)aPtr;
+            cl_ushort bPixel = *(cl_ushort *)bPtr;
+            return (aPixel & 0x7fff) == (bPixel & 0x7fff);
+        }
+
+        case CL_SNORM_INT8: {
+            // -1.0 is defined as 0x80 and 0x81
+            for (size_t i = 0; i < pixel_size; i++)
+            {
+                cl_uchar aPixel = ((cl_uchar *)aPtr)[i];
+                cl_uchar bPixel = ((cl_uchar *)bPtr)[i];
                 aPixel = (aPixel == 0x80) ? 0x81 : aPixel;
                 bPixel = (bPixel == 0x80) ? 0x81 : bPixel;
-                if (aPixel != bPixel)
-                {
-                    return column;
-                }
+                if (aPixel != bPixel) return false;
             }
-            break;
+            return true;
+        }
 
-            case CL_SNORM_INT16: {
-                cl_ushort aPixel = *(cl_ushort *)aPtr;
-                cl_ushort bPixel = *(cl_ushort *)bPtr;
-                // -1.0 is defined as 0x8000 and 0x8001
+        case CL_SNORM_INT16: {
+            // -1.0 is defined as 0x8000 and 0x8001
+            for (size_t i = 0; i < pixel_size / sizeof(cl_ushort); i++)
+            {
+                cl_ushort aPixel = ((cl_ushort *)aPtr)[i];
+                cl_ushort bPixel = ((cl_ushort *)bPtr)[i];
                 aPixel = (aPixel == 0x8000) ? 0x8001 : aPixel;
                 bPixel = (bPixel == 0x8000) ? 0x8001 : bPixel;
-                if (aPixel != bPixel)
-                {
-                    return column;
-                }
+                if (aPixel != bPixel) return false;
             }
-            break;
-
-            default:
-                if (memcmp(aPtr, bPtr, pixel_size) != 0) return column;
-                break;
+            return true;
         }
 
-        aPtr += pixel_size;
-        bPtr += pixel_size;
+        default: return memcmp(aPtr, bPtr, pixel_size) == 0;
+    }
+}
+
+// Returns the offset of the first byte in [offset, size) at which aPtr and bPtr
+// differ in any bit not cleared by the mask, or size if there is none. The
+// mask is a 16 byte pattern repeating from the start of the scanline, stored
+// twice so that it can be loaded at any rotation.
+static size_t find_first_masked_difference(const char *aPtr, const char *bPtr,
+                                           size_t offset, size_t size,
+                                           const cl_uchar mask[32])
+{
+#if defined(__SSE2__) || defined(_MSC_VER)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i m = _mm_loadu_si128((const __m128i *)(mask + (offset & 15)));
+    for (; offset + 16 <= size; offset += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(aPtr + offset));
+        __m128i b = _mm_loadu_si128((const __m128i *)(bPtr + offset));
+        __m128i diff = _mm_and_si128(_mm_xor_si128(a, b), m);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, zero)) != 0xffff) break;
+    }
+#else
+    cl_ulong m[2];
+    memcpy(m, mask + (offset & 15), sizeof(m));
+    for (; offset + 16 <= size; offset += 16)
+    {
+        cl_ulong a[2], b[2];
+        memcpy(a, aPtr + offset, sizeof(a));
+        memcpy(b, bPtr + offset, sizeof(b));
+        if (((a[0] ^ b[0]) & m[0]) | ((a[1] ^ b[1]) & m[1])) break;
+    }
+#endif
+
+    // Locate the differing byte within the last (possibly partial) chunk
+    for (; offset < size; offset++)
+    {
+        if ((aPtr[offset] ^ bPtr[offset]) & mask[offset & 15]) return offset;
+    }
+
+    return size;
+}
+
+size_t compare_scanlines(const cl_image_format *format, size_t width,
+                         const char *aPtr, const char *bPtr)
+{
+    size_t pixel_size = get_pixel_size(format);
+    size_t size = width * pixel_size;
+    cl_uchar mask[32];
+
+    get_undefined_bits_mask(format, mask);
+    memcpy(mask + 16, mask, 16);
+
+    // Scan in bulk for the first raw difference, then confirm it on a per pixel
+    // basis since some formats have several encodings for the same value.
+    size_t offset = 0;
+    while ((offset = find_first_masked_difference(aPtr, bPtr, offset, size,
+                                                  mask))
+           < size)
+    {
+        size_t column = offset / pixel_size;
+        if (!pixels_match(format, aPtr + column * pixel_size,
+                          bPtr + column * pixel_size, pixel_size))
+            return column;
+        offset = (column + 1) * pixel_size;
     }
 
     // If we didn't find a difference, return the width of the image
-    return column;
+    return width;
+}
+
+size_t compare_scanlines_exact(const cl_image_format *format, size_t width,
+                               const char *aPtr, const char *bPtr)
+{
+    size_t pixel_size = get_pixel_size(format);
+    cl_uchar mask[32];
+
+    get_undefined_bits_mask(format, mask);
+    memcpy(mask + 16, mask, 16);
+
+    return find_first_masked_difference(aPtr, bPtr, 0, width * pixel_size,
+                                        mask)
+        / pixel_size;
+}
+
+size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
+                         const char *bPtr)
+{
+    return compare_scanlines(imageInfo->format, imageInfo->width, aPtr, bPtr);
 }
 
 int random_log_in_range(int minV, int maxV, MTdata d)
@@ -1151,6 +1246,23 @@ cl_half convert_float_to_half(float f)
     }
 }
 
+void convert_float_array_to_half(cl_half *out, const float *in, size_t count)
+{
+    switch (gFloatToHalfRoundingMode)
+    {
+        case kRoundToNearestEven:
+            convert_floats_to_halves(out, in, count, CL_HALF_RTE);
+            break;
+        case kRoundTowardZero:
+            convert_floats_to_halves(out, in, count, CL_HALF_RTZ);
+            break;
+        default:
+            log_error("ERROR: Test internal error -- unhandled or unknown "
+                      "float->half rounding mode.\n");
+            exit(-1);
+    }
+}
+
 cl_ulong get_image_size(image_descriptor const *imageInfo)
 {
     cl_ulong imageSize;
@@ -1226,53 +1338,12 @@ void escape_inf_nan_subnormal_values(char *data, size_t allocSize)
     }
 }
 
-char *generate_random_image_data(image_descriptor *imageInfo,
-                                 BufferOwningPtr<char> &P, MTdata d)
+static void fill_random_image_data(image_descriptor *imageInfo, char *data,
+                                   size_t allocSize, MTdata d)
 {
-    size_t allocSize = static_cast<size_t>(get_image_size(imageInfo));
     size_t pixelRowBytes = imageInfo->width * get_pixel_size(imageInfo->format);
     size_t i;
 
-    if (imageInfo->num_mip_levels > 1)
-        allocSize =
-            static_cast<size_t>(compute_mipmapped_image_size(*imageInfo));
-
-#if defined(__APPLE__)
-    char *data = NULL;
-    if (gDeviceType == CL_DEVICE_TYPE_CPU)
-    {
-        size_t mapSize = ((allocSize + 4095L) & -4096L) + 8192;
-
-        void *map = mmap(0, mapSize, PROT_READ | PROT_WRITE,
-                         MAP_ANON | MAP_PRIVATE, 0, 0);
-        intptr_t data_end = (intptr_t)map + mapSize - 4096;
-        data = (char *)(data_end - (intptr_t)allocSize);
-
-        mprotect(map, 4096, PROT_NONE);
-        mprotect((void *)((char *)map + mapSize - 4096), 4096, PROT_NONE);
-        P.reset(data, map, mapSize, allocSize);
-    }
-    else
-    {
-        data = (char *)malloc(allocSize);
-        P.reset(data, NULL, 0, allocSize);
-    }
-#else
-    P.reset(NULL); // Free already allocated memory first, then try to allocate
-                   // new block.
-    char *data =
-        (char *)align_malloc(allocSize, get_pixel_alignment(imageInfo->format));
-    P.reset(data, NULL, 0, allocSize, true);
-#endif
-
-    if (data == NULL)
-    {
-        log_error("ERROR: Unable to malloc %zu bytes for "
-                  "generate_random_image_data\n",
-                  allocSize);
-        return 0;
-    }
-
     if (gTestRounding)
     {
         // Special case: fill with a ramp from 0 to the size of the type
@@ -1302,7 +1373,7 @@ char *generate_random_image_data(image_descriptor *imageInfo,
         // Note: inf or nan float values would cause problems, although we don't
         // know this will actually be a float, so we just know what to look for
         escape_inf_nan_subnormal_values(data, allocSize);
-        return data;
+        return;
     }
 
     // Otherwise, we should be able to just fill with random bits no matter what
@@ -1374,7 +1445,74 @@ char *generate_random_image_data(image_descriptor *imageInfo,
             }
         }
     }
+}
+
+char *generate_random_image_data(image_descriptor *imageInfo,
+                                 BufferOwningPtr<char> &P, MTdata d)
+{
+    size_t allocSize = static_cast<size_t>(get_image_size(imageInfo));
+
+    if (imageInfo->num_mip_levels > 1)
+        allocSize =
+            static_cast<size_t>(compute_mipmapped_image_size(*imageInfo));
+
+#if defined(__APPLE__)
+    char *data = NULL;
+    if (gDeviceType == CL_DEVICE_TYPE_CPU)
+    {
+        size_t mapSize = ((allocSize + 4095L) & -4096L) + 8192;
+
+        void *map = mmap(0, mapSize, PROT_READ | PROT_WRITE,
+                         MAP_ANON | MAP_PRIVATE, 0, 0);
+        intptr_t data_end = (intptr_t)map + mapSize - 4096;
+        data = (char *)(data_end - (intptr_t)allocSize);
+
+        mprotect(map, 4096, PROT_NONE);
+        mprotect((void *)((char *)map + mapSize - 4096), 4096, PROT_NONE);
+        P.reset(data, map, mapSize, allocSize);
+    }
+    else
+    {
+        data = (char *)malloc(allocSize);
+        P.reset(data, NULL, 0, allocSize);
+    }
+#else
+    P.reset(NULL); // Free already allocated memory first, then try to allocate
+                   // new block.
+    char *data =
+        (char *)align_malloc(allocSize, get_pixel_alignment(imageInfo->format));
+    P.reset(data, NULL, 0, allocSize, true);
+#endif
 
+    if (data == NULL)
+    {
+        log_error("ERROR: Unable to malloc %zu bytes for "
+                  "generate_random_image_data\n",
+                  allocSize);
+        return 0;
+    }
+
+    fill_random_image_data(imageInfo, data, allocSize, d);
+    return data;
+}
+
+char *generate_host_ptr_image_data(image_descriptor *imageInfo,
+                                   BufferOwningPtr<char> &P, MTdata d)
+{
+    size_t allocSize = static_cast<size_t>(get_image_size(imageInfo));
+
+    P.reset(NULL);
+    char *data = (char *)align_malloc(allocSize, 4096);
+    if (data == NULL)
+    {
+        log_error("ERROR: Unable to malloc %zu bytes for "
+                  "generate_host_ptr_image_data\n",
+                  allocSize);
+        return 0;
+    }
+    P.reset(data, NULL, 0, allocSize, true);
+
+    fill_random_image_data(imageInfo, data, allocSize, d);
     return data;
 }
 
@@ -3959,6 +4097,119 @@ cl_float CoordWalker::Get(size_t idx, size_t el)
         return mFloatCoords[idx * mVecSize + el];
 }
 
+MipmapReference::MipmapReference(void *imageData, image_descriptor *imageInfo,
+                                 bool decodeLevels)
+{
+    size_t numLevels =
+        (imageInfo->num_mip_levels > 1) ? imageInfo->num_mip_levels : 1;
+    size_t pixelSize = get_pixel_size(imageInfo->format);
+
+    mLevels.resize(numLevels);
+    for (size_t lod = 0; lod < numLevels; lod++)
+    {
+        Level &level = mLevels[lod];
+        level.info = *imageInfo;
+        level.data = (char *)imageData;
+
+        if (numLevels > 1)
+        {
+            // Mirror the level geometry derived by the samplers, with levels
+            // packed tightly one after the other.
+            switch (imageInfo->type)
+            {
+                case CL_MEM_OBJECT_IMAGE3D:
+                    level.info.depth = (imageInfo->depth >> lod)
+                        ? (imageInfo->depth >> lod)
+                        : 1;
+                case CL_MEM_OBJECT_IMAGE2D:
+                case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+                    level.info.height = (imageInfo->height >> lod)
+                        ? (imageInfo->height >> lod)
+                        : 1;
+                default:
+                    level.info.width = (imageInfo->width >> lod)
+                        ? (imageInfo->width >> lod)
+                        : 1;
+            }
+            level.info.rowPitch = level.info.width * pixelSize;
+            if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
+                level.info.slicePitch = level.info.rowPitch;
+            else if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D
+                     || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
+                level.info.slicePitch = level.info.rowPitch * level.info.height;
+            else
+                level.info.slicePitch = 0;
+            level.info.num_mip_levels = 0;
+            level.data += compute_mip_level_offset(imageInfo, lod);
+        }
+
+        // Images without mipmaps are sampled straight from their data.
+        if (!decodeLevels || numLevels == 1) continue;
+
+        // Decode to float RGBA, keeping the channels that the original order
+        // lacks implicit so that border colours stay the same.
+        cl_channel_order order = imageInfo->format->image_channel_order;
+        level.decodedFormat.image_channel_order = (order == CL_DEPTH)
+            ? CL_DEPTH
+            : (has_alpha(imageInfo->format) ? CL_RGBA : CL_RGB);
+        level.decodedFormat.image_channel_data_type = CL_FLOAT;
+
+        size_t channels = get_format_channel_count(&level.decodedFormat);
+        size_t rows = (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
+            ? 1
+            : std::max(level.info.height, (size_t)1);
+        size_t layers = 1;
+        if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D)
+            layers = level.info.depth;
+        else if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY
+                 || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
+            layers = imageInfo->arraySize;
+
+        level.decoded.resize(level.info.width * rows * layers * channels);
+        float *dst = level.decoded.data();
+        for (size_t z = 0; z < layers; z++)
+        {
+            for (size_t y = 0; y < rows; y++)
+            {
+                for (size_t x = 0; x < level.info.width; x++)
+                {
+                    float pixel[4];
+                    read_image_pixel_float(level.data, &level.info, (int)x,
+                                           (int)y, (int)z, pixel);
+                    for (size_t c = 0; c < channels; c++) *dst++ = pixel[c];
+                }
+            }
+        }
+
+        level.decodedInfo = level.info;
+        level.decodedInfo.rowPitch =
+            level.info.width * get_pixel_size(&level.decodedFormat);
+        if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
+            level.decodedInfo.slicePitch = level.decodedInfo.rowPitch;
+        else if (layers > 1)
+            level.decodedInfo.slicePitch = level.decodedInfo.rowPitch * rows;
+        else
+            level.decodedInfo.slicePitch = 0;
+        level.decodedInfo.num_mip_levels = 0;
+    }
+
+    // The vector is final now, so the format pointers can't dangle.
+    for (auto &level : mLevels)
+        if (!level.decoded.empty())
+            level.decodedInfo.format = &level.decodedFormat;
+}
+
+image_descriptor *MipmapReference::GetFloatLevelInfo(size_t lod)
+{
+    Level &level = mLevels[lod];
+    return level.decoded.empty() ? &level.info : &level.decodedInfo;
+}
+
+char *MipmapReference::GetFloatLevelData(size_t lod)
+{
+    Level &level = mLevels[lod];
+    return level.decoded.empty() ? level.data : (char *)level.decoded.data();
+}
 
 void print_read_header(const cl_image_format *format,
                        image_sampler_data *sampler, bool err, int t)
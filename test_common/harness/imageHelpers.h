@@ -140,9 +140,24 @@ void print_first_pixel_difference_error(size_t where, const char *sourcePixel,
                                         image_descriptor *imageInfo, size_t y,
                                         size_t thirdDim);
 
+// Fills mask with a 16 byte pattern, repeating every pixel, that clears the
+// bits of the format which are undefined. Returns false if every bit of the
+// format is defined.
+bool get_undefined_bits_mask(const cl_image_format *format, cl_uchar mask[16]);
+
+// Returns the first column at which the two scanlines differ, or width if they
+// match.
+size_t compare_scanlines(const cl_image_format *format, size_t width,
+                         const char *aPtr, const char *bPtr);
 size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
                          const char *bPtr);
 
+// Like compare_scanlines, but only the undefined bits are ignored: values with
+// several encodings, such as SNORM -1.0, must keep the exact encoding. Used
+// where the data is only moved, never converted.
+size_t compare_scanlines_exact(const cl_image_format *format, size_t width,
+                               const char *aPtr, const char *bPtr);
+
 void get_max_sizes(size_t *numberOfSizes, const int maxNumberOfSizes,
                    size_t sizes[][3], size_t maxWidth, size_t maxHeight,
                    size_t maxDepth, size_t maxArraySize,
@@ -158,6 +173,12 @@ extern cl_ulong get_image_size_mb(image_descriptor const *imageInfo);
 extern char *generate_random_image_data(image_descriptor *imageInfo,
                                         BufferOwningPtr<char> &Owner, MTdata d);
 
+// Like generate_random_image_data, but page-aligned, so that the data can be
+// passed as the host_ptr of a CL_MEM_USE_HOST_PTR image.
+extern char *generate_host_ptr_image_data(image_descriptor *imageInfo,
+                                          BufferOwningPtr<char> &Owner,
+                                          MTdata d);
+
 extern int debug_find_vector_in_image(void *imagePtr,
                                       image_descriptor *imageInfo,
                                       void *vectorToFind, size_t vectorSize,
@@ -771,7 +792,41 @@ protected:
     size_t mVecSize;
 };
 
+// Host reference for the levels of a (possibly mipmapped) image. The geometry
+// and data pointer of every level are computed once, and for float sampling
+// of mipmapped images each level can be decoded up front to RGBA floats so
+// that the reference sampler doesn't unpack the image format again for every
+// texel it touches.
+class MipmapReference {
+public:
+    MipmapReference(void *imageData, image_descriptor *imageInfo,
+                    bool decodeLevels);
+
+    size_t GetNumLevels() const { return mLevels.size(); }
+
+    // Describes level lod as a standalone image, so it can be handed to the
+    // regular sampling functions without passing a lod. This is the decoded
+    // copy of the level if there is one.
+    image_descriptor *GetFloatLevelInfo(size_t lod);
+    char *GetFloatLevelData(size_t lod);
+
+protected:
+    struct Level
+    {
+        image_descriptor info;
+        char *data;
+        cl_image_format decodedFormat;
+        image_descriptor decodedInfo;
+        std::vector<float> decoded;
+    };
+
+    std::vector<Level> mLevels;
+};
+
 extern cl_half convert_float_to_half(float f);
+// convert_float_to_half on every element of an array, converted in bulk
+extern void convert_float_array_to_half(cl_half *out, const float *in,
+                                        size_t count);
 extern int DetectFloatToHalfRoundingMode(
     cl_command_queue); // Returns CL_SUCCESS on success
 
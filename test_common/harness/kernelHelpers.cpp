@@ -30,6 +30,9 @@
 #include <iomanip>
 #include <mutex>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
 
 #if defined(_WIN32)
 std::string slash = "\\";
@@ -1232,48 +1235,213 @@ int get_max_common_3D_work_group_size(cl_context context, cl_kernel kernel,
     return 0;
 }
 
-/* Helper to determine if a device supports an image format */
-int is_image_format_supported(cl_context context, cl_mem_flags flags,
-                              cl_mem_object_type image_type,
-                              const cl_image_format *fmt)
+typedef std::tuple<cl_device_id, cl_mem_flags, cl_mem_object_type>
+    ImageFormatCacheKey;
+
+static std::mutex gImageFormatCacheMutex;
+static std::map<ImageFormatCacheKey, std::vector<cl_image_format>>
+    gImageFormatCache;
+static std::set<cl_device_id> gImageFormatCacheLoaded;
+// The device whose formats a context shares, resolved when the context is
+// first seen, or NULL when the formats of the context cannot be cached
+static std::map<cl_context, cl_device_id> gImageFormatCacheDevices;
+
+static std::string get_image_format_cache_filename(cl_device_id device)
+{
+    std::string deviceKey = get_device_info_string(device, CL_DEVICE_NAME);
+    deviceKey += get_device_info_string(device, CL_DEVICE_VERSION);
+    deviceKey += get_device_info_string(device, CL_DRIVER_VERSION);
+    cl_uint crc = crc32(deviceKey.data(), deviceKey.size());
+
+    std::ostringstream filenameStream;
+    filenameStream << gImageFormatCachePath << slash << "imageFormats-";
+    filenameStream << std::hex << std::setfill('0') << std::setw(8) << crc
+                   << ".txt";
+    return filenameStream.str();
+}
+
+/* Each line of the on-disk cache holds one query:
+ * <flags> <image type> <count> followed by count <order> <data type> pairs. */
+static void load_image_format_cache(cl_device_id device)
+{
+    std::ifstream ifs(get_image_format_cache_filename(device));
+    if (!ifs.good()) return;
+
+    cl_ulong flags;
+    cl_uint imageType;
+    size_t count;
+    while (ifs >> flags >> imageType >> count)
+    {
+        std::vector<cl_image_format> formats(count);
+        for (auto &format : formats)
+        {
+            if (!(ifs >> format.image_channel_order
+                  >> format.image_channel_data_type))
+                return;
+        }
+        gImageFormatCache[ImageFormatCacheKey(device, flags, imageType)] =
+            formats;
+    }
+}
+
+static void save_image_format_cache_entry(
+    cl_device_id device, cl_mem_flags flags, cl_mem_object_type image_type,
+    const std::vector<cl_image_format> &formats)
+{
+    std::ostringstream entry;
+    entry << flags << " " << image_type << " " << formats.size();
+    for (auto &format : formats)
+        entry << " " << format.image_channel_order << " "
+              << format.image_channel_data_type;
+    entry << "\n";
+
+    // Append the entry in one write, so binaries run in parallel at worst
+    // record a query twice.
+    std::ofstream ofs(get_image_format_cache_filename(device),
+                      std::ios::app);
+    if (!ofs.good())
+    {
+        log_info("Warning: can't write image format cache in %s\n",
+                 gImageFormatCachePath.c_str());
+        return;
+    }
+    ofs << entry.str();
+}
+
+/* The formats of a context only depend on its device when it has a single
+ * device and no properties beyond the platform. A context with several
+ * devices supports the intersection of their formats, and an interop context
+ * the formats it can share with the other API. */
+static cl_int get_image_format_cache_device(cl_context context,
+                                            cl_device_id &device,
+                                            bool &cacheable)
+{
+    cacheable = false;
+
+    cl_uint numDevices = 0;
+    cl_int error = clGetContextInfo(context, CL_CONTEXT_NUM_DEVICES,
+                                    sizeof(cl_uint), &numDevices, NULL);
+    test_error(error, "clGetContextInfo failed getting CL_CONTEXT_NUM_DEVICES");
+    if (numDevices != 1) return CL_SUCCESS;
+
+    size_t propertiesSize = 0;
+    error = clGetContextInfo(context, CL_CONTEXT_PROPERTIES, 0, NULL,
+                             &propertiesSize);
+    test_error(error, "clGetContextInfo failed getting CL_CONTEXT_PROPERTIES");
+    std::vector<cl_context_properties> properties(
+        propertiesSize / sizeof(cl_context_properties));
+    if (!properties.empty())
+    {
+        error = clGetContextInfo(context, CL_CONTEXT_PROPERTIES,
+                                 propertiesSize, properties.data(), NULL);
+        test_error(error,
+                   "clGetContextInfo failed getting CL_CONTEXT_PROPERTIES");
+    }
+    for (size_t i = 0; i + 1 < properties.size() && properties[i] != 0;
+         i += 2)
+    {
+        if (properties[i] != CL_CONTEXT_PLATFORM) return CL_SUCCESS;
+    }
+
+    error = get_first_device_id(context, device);
+    if (error != CL_SUCCESS) return error;
+    cacheable = true;
+    return CL_SUCCESS;
+}
+
+static int query_supported_image_formats(cl_context context,
+                                         cl_mem_flags flags,
+                                         cl_mem_object_type image_type,
+                                         std::vector<cl_image_format> &formats)
 {
-    cl_image_format *list;
     cl_uint count = 0;
-    cl_int err = clGetSupportedImageFormats(context, flags, image_type, 128,
-                                            NULL, &count);
-    if (count == 0) return 0;
+    cl_int error = clGetSupportedImageFormats(context, flags, image_type, 0,
+                                              NULL, &count);
+    test_error(error, "Unable to get count of supported image formats");
 
-    list = (cl_image_format *)malloc(count * sizeof(cl_image_format));
-    if (NULL == list)
+    formats.resize(count);
+    if (count > 0)
     {
-        log_error("Error: unable to allocate %zu byte buffer for image format "
-                  "list at %s:%d (err = %d)\n",
-                  count * sizeof(cl_image_format), __FILE__, __LINE__, err);
-        return 0;
+        error = clGetSupportedImageFormats(context, flags, image_type, count,
+                                           formats.data(), NULL);
+        test_error(error, "Unable to get list of supported image formats");
     }
-    BufferOwningPtr<cl_image_format> listBuf(list);
+    return CL_SUCCESS;
+}
 
+int get_supported_image_formats(cl_context context, cl_mem_flags flags,
+                                cl_mem_object_type image_type,
+                                std::vector<cl_image_format> &formats)
+{
+    std::unique_lock<std::mutex> lock(gImageFormatCacheMutex);
+
+    // A cache hit makes no driver calls at all
+    cl_device_id device = NULL;
+    cl_int error;
+    auto contextIt = gImageFormatCacheDevices.find(context);
+    if (contextIt != gImageFormatCacheDevices.end())
+        device = contextIt->second;
+    else
+    {
+        bool cacheable;
+        error = get_image_format_cache_device(context, device, cacheable);
+        if (error != CL_SUCCESS) return error;
+        if (!cacheable) device = NULL;
+        gImageFormatCacheDevices[context] = device;
+    }
+    if (device == NULL)
+    {
+        lock.unlock();
+        return query_supported_image_formats(context, flags, image_type,
+                                             formats);
+    }
 
-    cl_int error = clGetSupportedImageFormats(context, flags, image_type, count,
-                                              list, NULL);
-    if (error)
+    if (!gImageFormatCachePath.empty()
+        && gImageFormatCacheLoaded.insert(device).second)
+        load_image_format_cache(device);
+
+    ImageFormatCacheKey key(device, flags, image_type);
+    auto it = gImageFormatCache.find(key);
+    if (it != gImageFormatCache.end())
+    {
+        formats = it->second;
+        return CL_SUCCESS;
+    }
+
+    error = query_supported_image_formats(context, flags, image_type, formats);
+    if (error != CL_SUCCESS) return error;
+
+    gImageFormatCache[key] = formats;
+    if (!gImageFormatCachePath.empty())
+        save_image_format_cache_entry(device, flags, image_type, formats);
+
+    return CL_SUCCESS;
+}
+
+/* Helper to determine if a device supports an image format */
+int is_image_format_supported(cl_context context, cl_mem_flags flags,
+                              cl_mem_object_type image_type,
+                              const cl_image_format *fmt)
+{
+    std::vector<cl_image_format> list;
+    if (get_supported_image_formats(context, flags, image_type, list)
+        != CL_SUCCESS)
     {
-        log_error("Error: failed to obtain supported image type list at %s:%d "
-                  "(err = %d)\n",
-                  __FILE__, __LINE__, err);
+        log_error("Error: failed to obtain supported image type list at "
+                  "%s:%d\n",
+                  __FILE__, __LINE__);
         return 0;
     }
 
     // iterate looking for a match.
-    cl_uint i;
-    for (i = 0; i < count; i++)
+    for (auto &format : list)
     {
-        if (fmt->image_channel_data_type == list[i].image_channel_data_type
-            && fmt->image_channel_order == list[i].image_channel_order)
-            break;
+        if (fmt->image_channel_data_type == format.image_channel_data_type
+            && fmt->image_channel_order == format.image_channel_order)
+            return 1;
     }
 
-    return (i < count) ? 1 : 0;
+    return 0;
 }
 
 size_t get_pixel_bytes(const cl_image_format *fmt);
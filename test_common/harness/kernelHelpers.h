@@ -38,6 +38,7 @@
 #include "harness/alloc.h"
 
 #include <functional>
+#include <vector>
 
 #ifndef STRINGIFY_VALUE
 #define STRINGIFY_VALUE(_x) STRINGIFY(_x)
@@ -106,6 +107,15 @@ extern int get_max_allowed_1d_work_group_size_on_device(cl_device_id device,
                                                         cl_kernel kernel,
                                                         size_t *outSize);
 
+/* Helper to get the image formats supported by a context for the given flags
+ * and image type. For single device contexts without interop properties the
+ * results are cached per device for the life of the process and, if
+ * --image-format-cache-path is given, on disk keyed by the device and driver
+ * version. Other contexts are always queried. */
+extern int get_supported_image_formats(cl_context context, cl_mem_flags flags,
+                                       cl_mem_object_type image_type,
+                                       std::vector<cl_image_format> &formats);
+
 /* Helper to determine if a device supports an image format */
 extern int is_image_format_supported(cl_context context, cl_mem_flags flags,
                                      cl_mem_object_type image_type,
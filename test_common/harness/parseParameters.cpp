@@ -15,6 +15,7 @@
 //
 #include "parseParameters.h"
 
+#include "benchmarkHelpers.h"
 #include "errorHelpers.h"
 #include "testHarness.h"
 #include "ThreadPool.h"
@@ -34,6 +35,7 @@ std::string gCompilationCachePath = ".";
 std::string gCompilationProgram = DEFAULT_COMPILATION_PROGRAM;
 bool gDisableSPIRVValidation = false;
 std::string gSPIRVValidator = DEFAULT_SPIRV_VALIDATOR;
+std::string gImageFormatCachePath;
 unsigned gNumWorkerThreads;
 
 void helpInfo()
@@ -49,6 +51,16 @@ void helpInfo()
             spir-v     Use SPIR-V offline compilation
     --num-worker-threads <num>
         Select parallel execution with the specified number of worker threads.
+    --image-format-cache-path <path>
+        Persist supported image format queries under <path>, keyed by device
+        and driver version, so later runs skip re-querying the driver
+    --benchmark
+        Run the benchmarks of the test suite, which skip themselves otherwise
+    --benchmark-max-size <bytes>
+        Largest allocation a benchmark uses (default: its own limit)
+    --benchmark-samples <n>
+        Timed samples of every benchmark measurement (default: the count of
+        each benchmark)
 
 For offline compilation (binary and spir-v modes) only:
     --compilation-cache-mode <cache-mode>
@@ -211,6 +223,56 @@ int parseCustomParam(int argc, const char *argv[], const char *ignore)
                 return -1;
             }
         }
+        else if (!strcmp(argv[i], "--image-format-cache-path"))
+        {
+            delArg++;
+            if ((i + 1) < argc)
+            {
+                delArg++;
+                gImageFormatCachePath = argv[i + 1];
+            }
+            else
+            {
+                log_error("Path argument for --image-format-cache-path was "
+                          "not specified.\n");
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--benchmark"))
+        {
+            delArg++;
+            gBenchmark = true;
+        }
+        else if (!strcmp(argv[i], "--benchmark-max-size"))
+        {
+            delArg++;
+            if ((i + 1) < argc)
+            {
+                delArg++;
+                gBenchmarkMaxSize = strtoull(argv[i + 1], NULL, 0);
+            }
+            else
+            {
+                log_error("A parameter to --benchmark-max-size must be "
+                          "provided!\n");
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--benchmark-samples"))
+        {
+            delArg++;
+            if ((i + 1) < argc && atoi(argv[i + 1]) > 0)
+            {
+                delArg++;
+                gBenchmarkSamples = atoi(argv[i + 1]);
+            }
+            else
+            {
+                log_error("A positive parameter to --benchmark-samples must "
+                          "be provided!\n");
+                return -1;
+            }
+        }
         else if (!strcmp(argv[i], "--compilation-program"))
         {
             delArg++;
@@ -265,6 +327,83 @@ int parseCustomParam(int argc, const char *argv[], const char *ignore)
     return argc;
 }
 
+SuiteOption::SuiteOption(const char *name, bool *flag, const char *help)
+    : name(name), valueName(NULL), flag(flag), number(NULL), string(NULL),
+      help(help)
+{}
+
+SuiteOption::SuiteOption(const char *name, const char *valueName,
+                         unsigned *value, const char *help)
+    : name(name), valueName(valueName), flag(NULL), number(value),
+      string(NULL), help(help)
+{}
+
+SuiteOption::SuiteOption(const char *name, const char *valueName,
+                         std::string *value, const char *help)
+    : name(name), valueName(valueName), flag(NULL), number(NULL),
+      string(value), help(help)
+{}
+
+int parseSuiteOptions(int argc, const char *argv[], const char *title,
+                      const std::vector<SuiteOption> &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+        {
+            log_info("%s options:\n", title);
+            for (const SuiteOption &option : options)
+            {
+                std::string usage = option.name;
+                if (option.valueName)
+                    usage += std::string(" ") + option.valueName;
+                log_info("    %s\n        %s\n", usage.c_str(), option.help);
+            }
+            log_info("\n");
+            continue;
+        }
+
+        int delArg = 0;
+        for (const SuiteOption &option : options)
+        {
+            if (strcmp(argv[i], option.name)) continue;
+            delArg++;
+            if (option.flag)
+            {
+                *option.flag = true;
+                break;
+            }
+            if ((i + 1) >= argc)
+            {
+                log_error("A parameter to %s must be provided!\n",
+                          option.name);
+                return -1;
+            }
+            delArg++;
+            if (option.string)
+            {
+                *option.string = argv[i + 1];
+                break;
+            }
+            char *end;
+            unsigned long value = strtoul(argv[i + 1], &end, 0);
+            if (*end || end == argv[i + 1] || argv[i + 1][0] == '-')
+            {
+                log_error("Invalid value for %s: %s\n", option.name,
+                          argv[i + 1]);
+                return -1;
+            }
+            *option.number = (unsigned)value;
+            break;
+        }
+
+        for (int j = i; j < argc - delArg; j++) argv[j] = argv[j + delArg];
+        argc -= delArg;
+        i -= delArg;
+    }
+    return argc;
+}
+
 bool is_power_of_two(int number) { return number && !(number & (number - 1)); }
 
 extern void parseWimpyReductionFactor(const char *&arg,
@@ -18,6 +18,7 @@
 
 #include "compat.h"
 #include <string>
+#include <vector>
 
 enum CompilationMode
 {
@@ -40,10 +41,35 @@ extern std::string gCompilationCachePath;
 extern std::string gCompilationProgram;
 extern bool gDisableSPIRVValidation;
 extern std::string gSPIRVValidator;
+extern std::string gImageFormatCachePath;
 
 extern int parseCustomParam(int argc, const char *argv[],
                             const char *ignore = 0);
 
+// An option of a single test suite. Flags take no value, the other options
+// take the argument that follows them.
+struct SuiteOption
+{
+    SuiteOption(const char *name, bool *flag, const char *help);
+    SuiteOption(const char *name, const char *valueName, unsigned *value,
+                const char *help);
+    SuiteOption(const char *name, const char *valueName, std::string *value,
+                const char *help);
+
+    const char *name;
+    const char *valueName;
+    bool *flag;
+    unsigned *number;
+    std::string *string;
+    const char *help;
+};
+
+// Removes the suite options from argv and returns the new argc, or -1 if one
+// of them is malformed. -h and --help print the options under the title and
+// are left in argv for the harness.
+extern int parseSuiteOptions(int argc, const char *argv[], const char *title,
+                             const std::vector<SuiteOption> &options);
+
 extern void parseWimpyReductionFactor(const char *&arg,
                                       int &wimpyReductionFactor);
 
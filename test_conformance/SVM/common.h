@@ -85,5 +85,9 @@ extern cl_int create_cl_objects(cl_device_id device_from_harness, const char** p
 
 extern const char *linked_list_create_and_verify_kernels[];
 
+extern cl_uint gChaseNodes;
+extern cl_uint gChaseAllocations;
+extern std::string gChasePattern;
+
 #endif    // #ifndef __COMMON_H__
 
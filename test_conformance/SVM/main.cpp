@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <vector>
 #include <sstream>
+#include "harness/parseParameters.h"
 #include "harness/testHarness.h"
 #include "harness/kernelHelpers.h"
 
@@ -288,8 +289,22 @@ test_status InitCL(cl_device_id device) {
   return TEST_PASS;
 }
 
+cl_uint gChaseNodes = 1 << 22;
+cl_uint gChaseAllocations = 64;
+std::string gChasePattern = "all";
+
 int main(int argc, const char *argv[])
 {
+    argc = parseSuiteOptions(
+        argc, argv, "SVM",
+        { { "--chase-nodes", "<n>", &gChaseNodes,
+            "Nodes built by svm_pointer_chase_scale (default 4194304)" },
+          { "--chase-allocations", "<n>", &gChaseAllocations,
+            "SVM allocations the nodes are spread over (default 64)" },
+          { "--chase-pattern", "<p>", &gChasePattern,
+            "sequential, random, tree or all (default all)" } });
+    if (argc < 0) return EXIT_FAILURE;
+
     return runTestHarnessWithCheck(
         argc, argv, test_registry::getInstance().num_tests(),
         test_registry::getInstance().definitions(), true, 0, InitCL);
@@ -0,0 +1,368 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "common.h"
+#include "harness/alloc.h"
+#include "harness/benchmarkHelpers.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const char *benchmark_source[] = {
+    "__kernel void touch_pages(__global uint *p, uint words_per_page)\n"
+    "{\n"
+    "    size_t i = get_global_id(0);\n"
+    "    p[i * words_per_page] = (uint)i;\n"
+    "}\n"
+    "__kernel void ping_pong(__global volatile uint *p)\n"
+    "{\n"
+    "    p[0] = p[0] + 1;\n"
+    "}\n"
+};
+
+enum SVMKind
+{
+    kCoarseGrainBuffer,
+    kFineGrainBuffer,
+    kFineGrainSystem,
+    kNumSVMKinds
+};
+
+const char *svm_kind_names[kNumSVMKinds] = { "coarse_grain_buffer",
+                                             "fine_grain_buffer",
+                                             "fine_grain_system" };
+const cl_device_svm_capabilities svm_kind_caps[kNumSVMKinds] = {
+    CL_DEVICE_SVM_COARSE_GRAIN_BUFFER, CL_DEVICE_SVM_FINE_GRAIN_BUFFER,
+    CL_DEVICE_SVM_FINE_GRAIN_SYSTEM
+};
+
+const size_t kPageSize = 4096;
+const size_t kWordsPerPage = kPageSize / sizeof(cl_uint);
+
+// Host/device round trips measured per allocation kind, after one warm-up
+const int kPingPongRounds = 1000;
+
+// Fine-grain system allocations come from the host allocator, the others from
+// clSVMAlloc.
+struct SVMAllocation
+{
+    SVMAllocation(cl_context context, SVMKind kind, size_t size)
+        : context(context), kind(kind), size(size)
+    {
+        if (kind == kFineGrainSystem)
+            ptr = align_malloc(size, kPageSize);
+        else
+            ptr = clSVMAlloc(context,
+                             CL_MEM_READ_WRITE
+                                 | (kind == kFineGrainBuffer
+                                        ? CL_MEM_SVM_FINE_GRAIN_BUFFER
+                                        : 0),
+                             size, 0);
+        if (!ptr)
+            log_error("ERROR: unable to allocate %zu bytes of %s SVM\n", size,
+                      svm_kind_names[kind]);
+    }
+    ~SVMAllocation()
+    {
+        if (!ptr) return;
+        if (kind == kFineGrainSystem)
+            align_free(ptr);
+        else
+            clSVMFree(context, ptr);
+    }
+    SVMAllocation(const SVMAllocation &) = delete;
+    SVMAllocation &operator=(const SVMAllocation &) = delete;
+
+    cl_uint *words() const { return (cl_uint *)ptr; }
+
+    cl_context context;
+    SVMKind kind;
+    size_t size;
+    void *ptr;
+};
+
+// Only coarse-grain buffers have to be mapped before the host touches them
+int host_begin(cl_command_queue queue, const SVMAllocation &a,
+               cl_map_flags flags)
+{
+    if (a.kind != kCoarseGrainBuffer) return CL_SUCCESS;
+    int error =
+        clEnqueueSVMMap(queue, CL_TRUE, flags, a.ptr, a.size, 0, NULL, NULL);
+    test_error(error, "clEnqueueSVMMap failed");
+    return CL_SUCCESS;
+}
+
+int host_end(cl_command_queue queue, const SVMAllocation &a)
+{
+    if (a.kind != kCoarseGrainBuffer) return CL_SUCCESS;
+    int error = clEnqueueSVMUnmap(queue, a.ptr, 0, NULL, NULL);
+    test_error(error, "clEnqueueSVMUnmap failed");
+    return CL_SUCCESS;
+}
+
+void report_latency(SVMKind kind, std::vector<cl_ulong> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    log_info("PING_PONG %s rounds %zu us p50 %.2f p90 %.2f p99 %.2f max "
+             "%.2f\n",
+             svm_kind_names[kind], samples.size(),
+             sorted_percentile(samples, 50) * 1e-3,
+             sorted_percentile(samples, 90) * 1e-3,
+             sorted_percentile(samples, 99) * 1e-3, samples.back() * 1e-3);
+}
+
+// Migrates the whole allocation to the device and back to the host. Between
+// repeats the host writes every page of fine-grain allocations, so the next
+// migration to the device has something to move. Coarse-grain buffers can
+// only be touched through a map, which migrates them itself.
+int migration_bandwidth(cl_context context, cl_command_queue queue,
+                        SVMKind kind, size_t size)
+{
+    SVMAllocation a(context, kind, size);
+    if (!a.ptr) return -1;
+    const size_t words = size / sizeof(cl_uint);
+
+    int error = host_begin(queue, a, CL_MAP_WRITE);
+    if (error) return error;
+    for (size_t i = 0; i < words; i++) a.words()[i] = (cl_uint)i;
+    error = host_end(queue, a);
+    if (error) return error;
+
+    std::vector<cl_ulong> toDevice, toHost;
+    const void *ptrs[] = { a.ptr };
+    for (int r = 0; r <= benchmark_samples(); r++)
+    {
+        clEventWrapper deviceEvent, hostEvent;
+        error = clEnqueueSVMMigrateMem(queue, 1, ptrs, &size, 0, 0, NULL,
+                                       &deviceEvent);
+        test_error(error, "clEnqueueSVMMigrateMem to the device failed");
+        error = clEnqueueSVMMigrateMem(queue, 1, ptrs, &size,
+                                       CL_MIGRATE_MEM_OBJECT_HOST, 0, NULL,
+                                       &hostEvent);
+        test_error(error, "clEnqueueSVMMigrateMem to the host failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+
+        if (kind != kCoarseGrainBuffer)
+            for (size_t i = 0; i < words; i += kWordsPerPage)
+                a.words()[i] = (cl_uint)i;
+        if (r == 0) continue;
+        cl_ulong deviceNs, hostNs;
+        error = get_event_elapsed_ns(deviceEvent, deviceNs);
+        if (error) return error;
+        error = get_event_elapsed_ns(hostEvent, hostNs);
+        if (error) return error;
+        toDevice.push_back(deviceNs);
+        toHost.push_back(hostNs);
+    }
+    std::sort(toDevice.begin(), toDevice.end());
+    std::sort(toHost.begin(), toHost.end());
+    log_info("MIGRATION %s to_device %zu %.3f %.3f\n", svm_kind_names[kind],
+             size, (double)size / toDevice.front(),
+             (double)size / toDevice[toDevice.size() / 2]);
+    log_info("MIGRATION %s to_host %zu %.3f %.3f\n", svm_kind_names[kind],
+             size, (double)size / toHost.front(),
+             (double)size / toHost[toHost.size() / 2]);
+
+    // Migrations must not change the contents
+    error = host_begin(queue, a, CL_MAP_READ);
+    if (error) return error;
+    for (size_t i = 0; i < words; i++)
+    {
+        if (a.words()[i] != (cl_uint)i)
+        {
+            log_error("ERROR: %s word %zu is %u after migrations, expected "
+                      "%u\n",
+                      svm_kind_names[kind], i, a.words()[i], (cl_uint)i);
+            host_end(queue, a);
+            return -1;
+        }
+    }
+    return host_end(queue, a);
+}
+
+// The device writes one word per page of a fresh allocation twice, then the
+// host reads them back twice. The difference between the first and second
+// pass is the cost of faulting in or migrating the pages.
+int first_touch(cl_context context, cl_command_queue queue, cl_kernel kernel,
+                SVMKind kind, size_t size)
+{
+    SVMAllocation a(context, kind, size);
+    if (!a.ptr) return -1;
+    const size_t pages = size / kPageSize;
+    const cl_uint wordsPerPage = kWordsPerPage;
+
+    int error = clSetKernelArgSVMPointer(kernel, 0, a.ptr);
+    error |= clSetKernelArg(kernel, 1, sizeof(wordsPerPage), &wordsPerPage);
+    test_error(error, "Unable to set kernel arguments");
+    cl_ulong device[2];
+    for (int pass = 0; pass < 2; pass++)
+    {
+        clEventWrapper event;
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &pages, NULL, 0,
+                                       NULL, &event);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        error = get_event_elapsed_ns(event, device[pass]);
+        if (error) return error;
+    }
+
+    // A coarse-grain buffer moves to the host in the map, so it is timed with
+    // the first pass.
+    cl_ulong host[2];
+    auto start = BenchmarkClock::now();
+    error = host_begin(queue, a, CL_MAP_READ);
+    if (error) return error;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass) start = BenchmarkClock::now();
+        size_t wrong = 0;
+        for (size_t i = 0; i < pages; i++)
+            wrong += a.words()[i * kWordsPerPage] != (cl_uint)i;
+        host[pass] = host_elapsed_ns(start, BenchmarkClock::now());
+        if (wrong)
+        {
+            log_error("ERROR: %zu of %zu %s pages were not written by the "
+                      "device\n",
+                      wrong, pages, svm_kind_names[kind]);
+            host_end(queue, a);
+            return -1;
+        }
+    }
+    error = host_end(queue, a);
+    if (error) return error;
+
+    log_info("FIRST_TOUCH %s pages %zu device_first_us %.2f device_second_us "
+             "%.2f device_ns_per_page %.1f host_first_us %.2f "
+             "host_second_us %.2f host_ns_per_page %.1f\n",
+             svm_kind_names[kind], pages, device[0] * 1e-3, device[1] * 1e-3,
+             ((double)device[0] - device[1]) / pages, host[0] * 1e-3,
+             host[1] * 1e-3, ((double)host[0] - host[1]) / pages);
+    return CL_SUCCESS;
+}
+
+// Each round the host checks and increments a shared word, then a kernel
+// increments it again, so ownership of the page moves both ways.
+int ping_pong(cl_context context, cl_command_queue queue, cl_kernel kernel,
+              SVMKind kind)
+{
+    SVMAllocation a(context, kind, kPageSize);
+    if (!a.ptr) return -1;
+
+    int error = host_begin(queue, a, CL_MAP_WRITE);
+    if (error) return error;
+    a.words()[0] = 0;
+    error = host_end(queue, a);
+    if (error) return error;
+    error = clSetKernelArgSVMPointer(kernel, 0, a.ptr);
+    test_error(error, "Unable to set kernel arguments");
+
+    const size_t globalSize = 1;
+    const cl_uint rounds = benchmark_samples(kPingPongRounds);
+    std::vector<cl_ulong> samples;
+    for (cl_uint round = 0; round <= rounds; round++)
+    {
+        auto start = BenchmarkClock::now();
+        error = host_begin(queue, a, CL_MAP_READ | CL_MAP_WRITE);
+        if (error) return error;
+        cl_uint value = a.words()[0];
+        a.words()[0] = value + 1;
+        error = host_end(queue, a);
+        if (error) return error;
+        if (value != 2 * round)
+        {
+            log_error("ERROR: %s round %u read %u, expected %u\n",
+                      svm_kind_names[kind], round, value, 2 * round);
+            return -1;
+        }
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize,
+                                       NULL, 0, NULL, NULL);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        if (round)
+            samples.push_back(host_elapsed_ns(start, BenchmarkClock::now()));
+    }
+    report_latency(kind, samples);
+    return CL_SUCCESS;
+}
+
+}
+
+REGISTER_TEST(svm_migrate_benchmark)
+{
+    if (!gBenchmark)
+    {
+        log_info("Skipping, the SVM benchmark only runs with "
+                 "'--benchmark'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    clContextWrapper contextWrapper;
+    clProgramWrapper program;
+    clCommandQueueWrapper queues[MAXQ];
+    cl_uint num_devices = 0;
+    cl_int error = create_cl_objects(
+        device, &benchmark_source[0], &contextWrapper, &program, &queues[0],
+        &num_devices, CL_DEVICE_SVM_COARSE_GRAIN_BUFFER);
+    context = contextWrapper;
+    if (error == 1) return TEST_SKIPPED_ITSELF;
+    if (error < 0) return -1;
+
+    cl_queue_properties props[] = { CL_QUEUE_PROPERTIES,
+                                    CL_QUEUE_PROFILING_ENABLE, 0 };
+    clCommandQueueWrapper profilingQueue =
+        clCreateCommandQueueWithProperties(context, device, props, &error);
+    test_error(error, "Unable to create profiling queue");
+    clKernelWrapper touchKernel =
+        clCreateKernel(program, "touch_pages", &error);
+    test_error(error, "clCreateKernel failed");
+    clKernelWrapper pingKernel = clCreateKernel(program, "ping_pong", &error);
+    test_error(error, "clCreateKernel failed");
+
+    cl_device_svm_capabilities caps;
+    error = clGetDeviceInfo(device, CL_DEVICE_SVM_CAPABILITIES, sizeof(caps),
+                            &caps, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    std::vector<size_t> sizes;
+    error = get_benchmark_sizes(device, kPageSize, 0, sizes);
+    if (error) return error;
+
+    log_info("MIGRATION kind direction bytes best_GB/s median_GB/s\n");
+    for (int k = 0; k < kNumSVMKinds; k++)
+    {
+        SVMKind kind = (SVMKind)k;
+        if (!(caps & svm_kind_caps[kind]))
+        {
+            log_info("%s SVM is not supported, skipping it\n",
+                     svm_kind_names[kind]);
+            continue;
+        }
+        for (size_t size : sizes)
+        {
+            error = migration_bandwidth(context, profilingQueue, kind, size);
+            if (error) return error;
+        }
+        error = first_touch(context, profilingQueue, touchKernel, kind,
+                            sizes.back());
+        if (error) return error;
+        error = ping_pong(context, profilingQueue, pingKernel, kind);
+        if (error) return error;
+    }
+    return 0;
+}
@@ -0,0 +1,363 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "common.h"
+#include "harness/benchmarkHelpers.h"
+#include "harness/mt19937.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Every node has two successors, a walk picks one per hop from the bits of a
+// key derived from its work-item id. In lists both successors are the same
+// node. The walk of work-item i starts at starts[i].next[0].
+const char *chase_source[] = {
+    "typedef struct ChaseNode {\n"
+    "    __global struct ChaseNode *next[2];\n"
+    "    uint value;\n"
+    "    uint pad;\n"
+    "} ChaseNode;\n"
+    "\n"
+    "__kernel void chase(__global ChaseNode *starts, __global uint *sums,\n"
+    "                    uint steps)\n"
+    "{\n"
+    "    size_t i = get_global_id(0);\n"
+    "    __global ChaseNode *p = starts[i].next[0];\n"
+    "    uint key = (uint)i * 0x9E3779B9u;\n"
+    "    uint sum = 0;\n"
+    "    for (uint s = 0; s < steps; s++)\n"
+    "    {\n"
+    "        sum += p->value;\n"
+    "        p = p->next[(key >> (s & 31)) & 1];\n"
+    "    }\n"
+    "    sums[i] = sum;\n"
+    "}\n"
+};
+
+struct ChaseNode
+{
+    ChaseNode *next[2];
+    cl_uint value;
+    cl_uint pad;
+};
+
+enum ChasePattern
+{
+    kChaseSequential, // one list through the allocations in order
+    kChaseRandom, // one list visiting the nodes in random order
+    kChaseTree, // binary tree with randomly placed nodes, leaves link to root
+    kNumChasePatterns
+};
+
+const char *chase_pattern_names[kNumChasePatterns] = { "sequential", "random",
+                                                       "tree" };
+
+const cl_uint kChaseSteps = 256;
+const cl_uint kMaxChaseWorkItems = 65536;
+
+// The nodes are spread over many coarse-grain allocations, which the host
+// maps around every access.
+struct ChaseGraph
+{
+    cl_context context;
+    cl_command_queue queue;
+    cl_uint nodesPerAllocation;
+    std::vector<ChaseNode *> allocations;
+    ChaseNode *starts;
+    cl_uint *sums;
+    cl_uint workItems;
+
+    ~ChaseGraph()
+    {
+        for (ChaseNode *a : allocations) clSVMFree(context, a);
+        if (starts) clSVMFree(context, starts);
+        if (sums) clSVMFree(context, sums);
+    }
+
+    ChaseNode *node(cl_uint slot) const
+    {
+        return &allocations[slot / nodesPerAllocation]
+                           [slot % nodesPerAllocation];
+    }
+
+    std::vector<void *> pointers() const
+    {
+        std::vector<void *> ptrs(allocations.begin(), allocations.end());
+        ptrs.push_back(starts);
+        ptrs.push_back(sums);
+        return ptrs;
+    }
+
+    int map(cl_map_flags flags)
+    {
+        for (void *p : pointers())
+        {
+            int error = clEnqueueSVMMap(queue, CL_TRUE, flags, p,
+                                        size_of(p), 0, NULL, NULL);
+            test_error(error, "clEnqueueSVMMap failed");
+        }
+        return CL_SUCCESS;
+    }
+
+    int unmap()
+    {
+        for (void *p : pointers())
+        {
+            int error = clEnqueueSVMUnmap(queue, p, 0, NULL, NULL);
+            test_error(error, "clEnqueueSVMUnmap failed");
+        }
+        int error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return CL_SUCCESS;
+    }
+
+    size_t size_of(void *p) const
+    {
+        if (p == starts) return workItems * sizeof(ChaseNode);
+        if (p == sums) return workItems * sizeof(cl_uint);
+        return nodesPerAllocation * sizeof(ChaseNode);
+    }
+};
+
+int allocate_graph(ChaseGraph &g, cl_uint numNodes, cl_uint numAllocations)
+{
+    g.nodesPerAllocation = (numNodes + numAllocations - 1) / numAllocations;
+    g.workItems = std::min(numNodes, kMaxChaseWorkItems);
+    g.starts = (ChaseNode *)clSVMAlloc(
+        g.context, CL_MEM_READ_WRITE, g.workItems * sizeof(ChaseNode), 0);
+    g.sums = (cl_uint *)clSVMAlloc(g.context, CL_MEM_READ_WRITE,
+                                   g.workItems * sizeof(cl_uint), 0);
+    if (!g.starts || !g.sums)
+    {
+        log_error("ERROR: clSVMAlloc failed for the walk starts and sums\n");
+        return -1;
+    }
+    for (cl_uint a = 0; a < numAllocations; a++)
+    {
+        ChaseNode *p = (ChaseNode *)clSVMAlloc(
+            g.context, CL_MEM_READ_WRITE,
+            g.nodesPerAllocation * sizeof(ChaseNode), 0);
+        if (!p)
+        {
+            log_error("ERROR: clSVMAlloc failed for allocation %u of %u "
+                      "(%zu bytes)\n",
+                      a, numAllocations,
+                      g.nodesPerAllocation * sizeof(ChaseNode));
+            return -1;
+        }
+        g.allocations.push_back(p);
+    }
+    return CL_SUCCESS;
+}
+
+// order[k] is the slot holding logical node k
+void link_graph(ChaseGraph &g, ChasePattern pattern,
+                const std::vector<cl_uint> &order, MTdata d)
+{
+    const cl_uint numNodes = (cl_uint)order.size();
+    for (cl_uint k = 0; k < numNodes; k++)
+    {
+        ChaseNode *n = g.node(order[k]);
+        n->value = genrand_int32(d);
+        n->pad = 0;
+        if (pattern == kChaseTree)
+        {
+            for (cl_uint c = 0; c < 2; c++)
+            {
+                cl_ulong child = 2 * (cl_ulong)k + 1 + c;
+                n->next[c] = g.node(child < numNodes ? order[child] : order[0]);
+            }
+        }
+        else
+        {
+            n->next[0] = n->next[1] = g.node(order[(k + 1) % numNodes]);
+        }
+    }
+
+    // Lists start evenly spread along the list, trees all start at the root
+    for (cl_uint i = 0; i < g.workItems; i++)
+    {
+        cl_ulong k = pattern == kChaseTree
+            ? 0
+            : (cl_ulong)i * numNodes / g.workItems;
+        g.starts[i].next[0] = g.starts[i].next[1] = g.node(order[k]);
+        g.starts[i].value = g.starts[i].pad = 0;
+    }
+}
+
+int run_pattern(ChaseGraph &g, cl_kernel kernel, ChasePattern pattern,
+                cl_uint numNodes, MTdata d)
+{
+    std::vector<cl_uint> order(numNodes);
+    for (cl_uint k = 0; k < numNodes; k++) order[k] = k;
+    if (pattern != kChaseSequential)
+        for (cl_uint k = numNodes - 1; k > 0; k--)
+            std::swap(order[k], order[genrand_int32(d) % (k + 1)]);
+
+    auto start = BenchmarkClock::now();
+    int error = g.map(CL_MAP_WRITE);
+    if (error) return error;
+    link_graph(g, pattern, order, d);
+    error = g.unmap();
+    if (error) return error;
+    double buildMs = host_elapsed_ns(start, BenchmarkClock::now()) * 1e-6;
+
+    // Only the starts and sums are kernel arguments, every other allocation
+    // is reached through pointers in the nodes.
+    std::vector<void *> ptrs = g.pointers();
+    const cl_uint steps = kChaseSteps;
+    error = clSetKernelArgSVMPointer(kernel, 0, g.starts);
+    error |= clSetKernelArgSVMPointer(kernel, 1, g.sums);
+    error |= clSetKernelArg(kernel, 2, sizeof(steps), &steps);
+    test_error(error, "Unable to set kernel arguments");
+    error = clSetKernelExecInfo(kernel, CL_KERNEL_EXEC_INFO_SVM_PTRS,
+                                ptrs.size() * sizeof(void *), ptrs.data());
+    test_error(error, "clSetKernelExecInfo failed");
+
+    // The first launch warms up the translations, then one launch is timed,
+    // or the median of --benchmark-samples launches is taken
+    const size_t globalSize = g.workItems;
+    std::vector<cl_ulong> times;
+    for (int pass = 0; pass <= benchmark_samples(1); pass++)
+    {
+        clEventWrapper event;
+        error = clEnqueueNDRangeKernel(g.queue, kernel, 1, NULL, &globalSize,
+                                       NULL, 0, NULL, &event);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFinish(g.queue);
+        test_error(error, "clFinish failed");
+        // Never 0, so the hop rate below stays finite on coarse timers
+        cl_ulong ns;
+        error = get_event_elapsed_ns(event, ns);
+        if (error) return error;
+        if (pass > 0) times.push_back(ns);
+    }
+    std::sort(times.begin(), times.end());
+    const cl_ulong deviceNs = sorted_percentile(times, 50);
+
+    // Repeat every walk on the host
+    start = BenchmarkClock::now();
+    error = g.map(CL_MAP_READ);
+    if (error) return error;
+    cl_uint wrong = 0;
+    for (cl_uint i = 0; i < g.workItems; i++)
+    {
+        const ChaseNode *p = g.starts[i].next[0];
+        cl_uint key = i * 0x9E3779B9U;
+        cl_uint sum = 0;
+        for (cl_uint s = 0; s < steps; s++)
+        {
+            sum += p->value;
+            p = p->next[(key >> (s & 31)) & 1];
+        }
+        if (sum != g.sums[i] && wrong++ < 10)
+            log_error("ERROR: %s walk %u summed %u, expected %u\n",
+                      chase_pattern_names[pattern], i, g.sums[i], sum);
+    }
+    error = g.unmap();
+    if (error) return error;
+    double verifyMs = host_elapsed_ns(start, BenchmarkClock::now()) * 1e-6;
+
+    double hops = (double)g.workItems * steps;
+    log_info("POINTER_CHASE %s nodes %u allocations %zu work_items %u hops "
+             "%.0f build_ms %.1f device_ms %.3f hops_per_second %.0f "
+             "verify_ms %.1f\n",
+             chase_pattern_names[pattern], numNodes, g.allocations.size(),
+             g.workItems, hops, buildMs, deviceNs * 1e-6,
+             hops * 1e9 / deviceNs, verifyMs);
+    if (wrong)
+    {
+        log_error("ERROR: %u of %u %s walks differ from the host\n", wrong,
+                  g.workItems, chase_pattern_names[pattern]);
+        return -1;
+    }
+    return CL_SUCCESS;
+}
+
+}
+
+REGISTER_TEST(svm_pointer_chase_scale)
+{
+    if (!gBenchmark)
+    {
+        log_info("Skipping, the pointer chasing scale test only runs with "
+                 "'--benchmark'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    int pattern = -1;
+    for (int p = 0; p < kNumChasePatterns; p++)
+        if (gChasePattern == chase_pattern_names[p]) pattern = p;
+    if (pattern < 0 && gChasePattern != "all")
+    {
+        log_error("ERROR: unknown --chase-pattern %s\n",
+                  gChasePattern.c_str());
+        return -1;
+    }
+    if (gChaseNodes < 1 || gChaseAllocations < 1
+        || gChaseAllocations > gChaseNodes)
+    {
+        log_error("ERROR: need at least one node per allocation\n");
+        return -1;
+    }
+
+    cl_uint addressBits;
+    cl_int error = clGetDeviceInfo(device, CL_DEVICE_ADDRESS_BITS,
+                                   sizeof(addressBits), &addressBits, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    if (addressBits != sizeof(void *) * 8)
+    {
+        log_info("Device pointers are %u bits and host pointers %zu, "
+                 "skipping\n",
+                 addressBits, sizeof(void *) * 8);
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    clContextWrapper contextWrapper;
+    clProgramWrapper program;
+    clCommandQueueWrapper queues[MAXQ];
+    cl_uint num_devices = 0;
+    error = create_cl_objects(device, &chase_source[0], &contextWrapper,
+                              &program, &queues[0], &num_devices,
+                              CL_DEVICE_SVM_COARSE_GRAIN_BUFFER);
+    context = contextWrapper;
+    if (error == 1) return TEST_SKIPPED_ITSELF;
+    if (error < 0) return -1;
+
+    cl_queue_properties props[] = { CL_QUEUE_PROPERTIES,
+                                    CL_QUEUE_PROFILING_ENABLE, 0 };
+    clCommandQueueWrapper profilingQueue =
+        clCreateCommandQueueWithProperties(context, device, props, &error);
+    test_error(error, "Unable to create profiling queue");
+    clKernelWrapper kernel = clCreateKernel(program, "chase", &error);
+    test_error(error, "clCreateKernel failed");
+
+    ChaseGraph g = {};
+    g.context = context;
+    g.queue = profilingQueue;
+    error = allocate_graph(g, gChaseNodes, gChaseAllocations);
+    if (error) return error;
+
+    MTdataHolder d(gRandomSeed);
+    for (int p = 0; p < kNumChasePatterns; p++)
+    {
+        if (pattern >= 0 && p != pattern) continue;
+        error = run_pattern(g, kernel, (ChasePattern)p, gChaseNodes, d);
+        if (error) return error;
+    }
+    return 0;
+}
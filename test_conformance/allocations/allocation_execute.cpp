@@ -15,7 +15,9 @@
 //
 #include "allocation_execute.h"
 #include "allocation_functions.h"
+#include "harness/ThreadPool.h"
 
+#include <algorithm>
 #include <vector>
 
 
@@ -76,6 +78,64 @@ const char *write_pattern = {
 };
 
 
+struct CheckImageInfo
+{
+    cl_command_queue queue;
+    cl_mem mem;
+    size_t width, height, lines_per_chunk;
+    volatile cl_int mismatches;
+};
+
+// Checks the pixels where the driver maps them, one band of lines per thread
+// pool job.
+static cl_int check_image_chunk(cl_uint job_id, cl_uint thread_id,
+                                void *userInfo)
+{
+    CheckImageInfo *info = (CheckImageInfo *)userInfo;
+    size_t origin[3] = { 0, job_id * info->lines_per_chunk, 0 };
+    size_t region[3] = {
+        info->width,
+        std::min(info->lines_per_chunk, info->height - origin[1]), 1
+    };
+    size_t row_pitch, x, y, j;
+    cl_int error;
+    bool mismatch = false;
+
+    char *data = (char *)clEnqueueMapImage(
+        info->queue, info->mem, CL_TRUE, CL_MAP_READ, origin, region,
+        &row_pitch, NULL, 0, NULL, NULL, &error);
+    if (error) return error;
+
+    for (y = origin[1]; y < origin[1] + region[1] && !mismatch; y++)
+    {
+        cl_uint *row = (cl_uint *)(data + (y - origin[1]) * row_pitch);
+        for (x = 0; x < info->width && !mismatch; x++)
+        {
+            for (j = 0; j < 4; j++)
+            {
+                if (row[x * 4 + j] == (cl_uint)(x * y + j)) continue;
+                if (ThreadPool_AtomicAdd(&info->mismatches, 1) == 0)
+                    log_error(
+                        "Pixel %d, %d, component %d, expected %u, got %u.\n",
+                        (int)x, (int)y, (int)j, (cl_uint)(x * y + j),
+                        row[x * 4 + j]);
+                mismatch = true;
+                break;
+            }
+        }
+    }
+
+    cl_event event;
+    error = clEnqueueUnmapMemObject(info->queue, info->mem, data, 0, NULL,
+                                    &event);
+    if (error == CL_SUCCESS)
+    {
+        error = clWaitForEvents(1, &event);
+        clReleaseEvent(event);
+    }
+    return mismatch ? -1 : error;
+}
+
 int check_image(cl_command_queue queue, cl_mem mem)
 {
     int error;
@@ -117,6 +177,27 @@ int check_image(cl_command_queue queue, cl_mem mem)
         default: log_error("unexpected object type"); return -1;
     }
 
+    if (g_chunked_fill)
+    {
+        CheckImageInfo info;
+        info.queue = queue;
+        info.mem = mem;
+        info.width = width;
+        info.height = height;
+        info.lines_per_chunk = std::max(
+            (size_t)1, CHUNKED_FILL_SIZE / (width * 4 * sizeof(cl_uint)));
+        info.mismatches = 0;
+        cl_uint chunks = (cl_uint)((height + info.lines_per_chunk - 1)
+                                   / info.lines_per_chunk);
+        error = ThreadPool_Do(check_image_chunk, chunks, &info);
+        if (info.mismatches) return -1;
+        if (error)
+        {
+            print_error(error, "Checking image in chunks failed");
+            return error;
+        }
+        return 0;
+    }
 
     data = (cl_uint *)malloc(width * 4 * sizeof(cl_uint));
     if (data == NULL)
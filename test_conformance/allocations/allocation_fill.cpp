@@ -19,6 +19,158 @@
 #define IMAGE_LINES 8
 
 #include "harness/compat.h"
+#include "harness/ThreadPool.h"
+
+#include <algorithm>
+#include <vector>
+
+// splitmix64 moves its state by a constant step per value, so the generator
+// can be seeked to any word of an allocation and every chunk can be filled
+// independently of the others.
+#define CHUNK_RANDOM_STEP 0x9E3779B97F4A7C15ULL
+
+struct ChunkRandom
+{
+    ChunkRandom(cl_ulong seed, size_t word)
+        : state(seed + CHUNK_RANDOM_STEP * (cl_ulong)word)
+    {}
+    cl_uint next()
+    {
+        cl_ulong z = (state += CHUNK_RANDOM_STEP);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return (cl_uint)(z ^ (z >> 31));
+    }
+    cl_ulong state;
+};
+
+struct ChunkedFillInfo
+{
+    cl_command_queue queue;
+    cl_mem mem;
+    cl_ulong seed;
+    cl_bool blocking_write;
+    size_t size; // buffers
+    size_t width, height, lines_per_chunk; // images
+    std::vector<cl_uint> sums; // checksum of each chunk
+};
+
+static cl_int wait_for_event(cl_event event)
+{
+    cl_int error = clWaitForEvents(1, &event);
+    if (error == CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST)
+        clGetEventInfo(event, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                       sizeof(error), &error, NULL);
+    clReleaseEvent(event);
+    return error;
+}
+
+// Waits for the unmap so that no more than one chunk per thread is mapped at
+// any time.
+static cl_int unmap_chunk(const ChunkedFillInfo *info, void *data,
+                          cl_int error)
+{
+    cl_event event;
+    cl_int unmap_error = clEnqueueUnmapMemObject(info->queue, info->mem, data,
+                                                 0, NULL, &event);
+    if (unmap_error == CL_SUCCESS) unmap_error = wait_for_event(event);
+    return error ? error : unmap_error;
+}
+
+static cl_int fill_buffer_chunk(cl_uint job_id, cl_uint thread_id,
+                                void *userInfo)
+{
+    ChunkedFillInfo *info = (ChunkedFillInfo *)userInfo;
+    size_t offset = (size_t)job_id * CHUNKED_FILL_SIZE;
+    size_t size = std::min((size_t)CHUNKED_FILL_SIZE, info->size - offset);
+    cl_event event;
+    cl_int error;
+
+    cl_uint *data = (cl_uint *)clEnqueueMapBuffer(
+        info->queue, info->mem, info->blocking_write,
+        CL_MAP_WRITE_INVALIDATE_REGION, offset, size, 0, NULL,
+        info->blocking_write ? NULL : &event, &error);
+    if (error != CL_SUCCESS) return error;
+    if (!info->blocking_write) error = wait_for_event(event);
+    if (error != CL_SUCCESS) return unmap_chunk(info, data, error);
+
+    ChunkRandom random(info->seed, offset / sizeof(cl_uint));
+    cl_uint sum = 0;
+    for (size_t j = 0; j < size / sizeof(cl_uint); j++)
+    {
+        data[j] = random.next();
+        sum += data[j];
+    }
+    info->sums[job_id] = sum;
+    return unmap_chunk(info, data, CL_SUCCESS);
+}
+
+static cl_int fill_image_chunk(cl_uint job_id, cl_uint thread_id,
+                               void *userInfo)
+{
+    ChunkedFillInfo *info = (ChunkedFillInfo *)userInfo;
+    size_t origin[3] = { 0, job_id * info->lines_per_chunk, 0 };
+    size_t region[3] = {
+        info->width,
+        std::min(info->lines_per_chunk, info->height - origin[1]), 1
+    };
+    size_t row_pitch;
+    cl_event event;
+    cl_int error;
+
+    char *data = (char *)clEnqueueMapImage(
+        info->queue, info->mem, info->blocking_write,
+        CL_MAP_WRITE_INVALIDATE_REGION, origin, region, &row_pitch, NULL, 0,
+        NULL, info->blocking_write ? NULL : &event, &error);
+    if (error != CL_SUCCESS) return error;
+    if (!info->blocking_write) error = wait_for_event(event);
+    if (error != CL_SUCCESS) return unmap_chunk(info, data, error);
+
+    cl_uint sum = 0;
+    for (size_t y = 0; y < region[1]; y++)
+    {
+        cl_uint *row = (cl_uint *)(data + y * row_pitch);
+        ChunkRandom random(info->seed, (origin[1] + y) * info->width * 4);
+        for (size_t j = 0; j < info->width * 4; j++)
+        {
+            row[j] = random.next();
+            sum += row[j];
+        }
+    }
+    info->sums[job_id] = sum;
+    return unmap_chunk(info, data, CL_SUCCESS);
+}
+
+// Generates the data where the driver maps it instead of in a host copy of
+// the whole object, one chunk per thread pool job.
+static int fill_mem_chunked(cl_context context, cl_device_id device_id,
+                            cl_command_queue *queue, cl_mem mem,
+                            ChunkedFillInfo &info, TPFuncPtr fill_chunk,
+                            cl_uint chunks, MTdata d)
+{
+    info.queue = *queue;
+    info.mem = mem;
+    info.seed = (cl_ulong)genrand_int32(d) << 32;
+    info.seed |= genrand_int32(d);
+    info.sums.assign(chunks, 0);
+
+    cl_int error = ThreadPool_Do(fill_chunk, chunks, &info);
+    int result = check_allocation_error(context, device_id, error, queue);
+    if (result == FAILED_ABORT)
+    {
+        print_error(error, "Filling memory object in chunks failed.");
+    }
+    if (result != SUCCEEDED)
+    {
+        clFinish(*queue);
+        clReleaseMemObject(mem);
+        return result;
+    }
+
+    // Only update the checksum if this succeeded.
+    for (cl_uint sum : info.sums) checksum += sum;
+    return SUCCEEDED;
+}
 
 int fill_buffer_with_data(cl_context context, cl_device_id device_id,
                           cl_command_queue *queue, cl_mem mem, size_t size,
@@ -30,6 +182,17 @@ int fill_buffer_with_data(cl_context context, cl_device_id device_id,
     cl_uint checksum_delta = 0;
     cl_event event;
 
+    if (g_chunked_fill)
+    {
+        ChunkedFillInfo info;
+        info.blocking_write = blocking_write;
+        info.size = size;
+        cl_uint chunks =
+            (cl_uint)((size + CHUNKED_FILL_SIZE - 1) / CHUNKED_FILL_SIZE);
+        return fill_mem_chunked(context, device_id, queue, mem, info,
+                                fill_buffer_chunk, chunks, d);
+    }
+
     size_t size_to_use = BUFFER_CHUNK_SIZE;
     if (size_to_use > size) size_to_use = size;
 
@@ -194,6 +357,20 @@ int fill_image_with_data(cl_context context, cl_device_id device_id,
     cl_uint checksum_delta = 0;
     cl_event event;
 
+    if (g_chunked_fill)
+    {
+        ChunkedFillInfo info;
+        info.blocking_write = blocking_write;
+        info.width = width;
+        info.height = height;
+        info.lines_per_chunk = std::max(
+            (size_t)1, CHUNKED_FILL_SIZE / (width * 4 * sizeof(cl_uint)));
+        cl_uint chunks = (cl_uint)((height + info.lines_per_chunk - 1)
+                                   / info.lines_per_chunk);
+        return fill_mem_chunked(context, device_id, queue, mem, info,
+                                fill_image_chunk, chunks, d);
+    }
+
     size_t image_lines_to_use;
     image_lines_to_use = IMAGE_LINES;
     if (image_lines_to_use > height) image_lines_to_use = height;
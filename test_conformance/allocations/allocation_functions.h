@@ -16,6 +16,8 @@
 #include "testBase.h"
 #include "allocation_utils.h"
 
+int find_good_image_size(cl_device_id device_id, size_t size_to_allocate,
+                         size_t *width, size_t *height, size_t *max_size);
 int do_allocation(cl_context context, cl_command_queue *queue,
                   cl_device_id device_id, size_t size_to_allocate, int type,
                   cl_mem *mem);
@@ -0,0 +1,234 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "allocation_scenarios.h"
+#include "allocation_functions.h"
+#include "harness/benchmarkHelpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static const cl_image_format scenario_image_format = { CL_RGBA,
+                                                       CL_UNSIGNED_INT32 };
+
+// Sizes are drawn log-uniformly between these bounds, the upper one relative
+// to the largest single allocation
+#define SCENARIO_MIN_SIZE (4 * 1024)
+#define SCENARIO_MAX_SIZE_DIVISOR 4
+
+// Largest-allocation probes are done to this granularity
+#define SCENARIO_PROBE_GRANULARITY (1024 * 1024)
+
+struct ScenarioObject
+{
+    cl_mem mem;
+    size_t size;
+};
+
+static double random_unit(MTdata d)
+{
+    return genrand_int32(d) / 4294967296.0;
+}
+
+// Creates the object and writes to its last byte or pixel, so drivers that
+// only back memory on first use have to do so inside the timed region. If
+// footprint is not NULL it is set to the size the object really takes, which
+// for images differs from the requested size.
+static int create_and_touch(cl_context context, cl_command_queue *queue,
+                            cl_device_id device_id, bool image, size_t size,
+                            cl_mem *mem, size_t *footprint)
+{
+    int error;
+    *mem = NULL;
+    if (image)
+    {
+        size_t width, height;
+        error = find_good_image_size(device_id, size, &width, &height, NULL);
+        if (error != SUCCEEDED) return error;
+        *mem = create_image_2d(context, CL_MEM_READ_ONLY,
+                               &scenario_image_format, width, height, 0, NULL,
+                               &error);
+        error = check_allocation_error(context, device_id, error, queue);
+        if (error != SUCCEEDED) return error;
+
+        const cl_uint pixel[4] = { 0 };
+        const size_t origin[3] = { width - 1, height - 1, 0 };
+        const size_t region[3] = { 1, 1, 1 };
+        error = clEnqueueWriteImage(*queue, *mem, CL_TRUE, origin, region, 0,
+                                    0, pixel, 0, NULL, NULL);
+    }
+    else
+    {
+        *mem = clCreateBuffer(context, CL_MEM_READ_WRITE, size, NULL, &error);
+        error = check_allocation_error(context, device_id, error, queue);
+        if (error != SUCCEEDED) return error;
+
+        const cl_uchar byte = 0;
+        error = clEnqueueWriteBuffer(*queue, *mem, CL_TRUE, size - 1, 1, &byte,
+                                     0, NULL, NULL);
+    }
+    error = check_allocation_error(context, device_id, error, queue);
+    if (error == SUCCEEDED && footprint)
+    {
+        error = clGetMemObjectInfo(*mem, CL_MEM_SIZE, sizeof(*footprint),
+                                   footprint, NULL);
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "clGetMemObjectInfo failed for CL_MEM_SIZE.");
+            error = FAILED_ABORT;
+        }
+    }
+    if (error != SUCCEEDED)
+    {
+        clReleaseMemObject(*mem);
+        *mem = NULL;
+    }
+    return error;
+}
+
+// Binary search for the largest buffer that can be created and used now
+static int probe_largest_buffer(cl_context context, cl_command_queue *queue,
+                                cl_device_id device_id, size_t max_size,
+                                size_t *largest)
+{
+    size_t lo = 0, hi = max_size / SCENARIO_PROBE_GRANULARITY;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        cl_mem mem;
+        int error = create_and_touch(context, queue, device_id, false,
+                                     mid * SCENARIO_PROBE_GRANULARITY, &mem,
+                                     NULL);
+        if (error == FAILED_ABORT) return error;
+        if (error == SUCCEEDED)
+        {
+            clReleaseMemObject(mem);
+            lo = mid;
+        }
+        else
+            hi = mid - 1;
+    }
+    *largest = lo * SCENARIO_PROBE_GRANULARITY;
+    return SUCCEEDED;
+}
+
+static void report_latency(const char *name, std::vector<double> us)
+{
+    if (us.empty()) return;
+    std::sort(us.begin(), us.end());
+    log_info("\tALLOC_LATENCY %s count %zu us p50 %.1f p90 %.1f p99 %.1f max "
+             "%.1f\n",
+             name, us.size(), sorted_percentile(us, 50),
+             sorted_percentile(us, 90), sorted_percentile(us, 99), us.back());
+}
+
+int run_fragmentation_scenario(cl_context context, cl_command_queue *queue,
+                               cl_device_id device_id, size_t budget,
+                               size_t max_individual_size, int steps,
+                               MTdata d)
+{
+    const bool images = checkForImageSupport(device_id) == 0;
+    const double log_min = log((double)SCENARIO_MIN_SIZE);
+    const double log_max =
+        log((double)std::max<size_t>(SCENARIO_MIN_SIZE,
+                                     max_individual_size
+                                         / SCENARIO_MAX_SIZE_DIVISOR));
+    const int probe_interval = std::max(1, steps / 8);
+
+    std::vector<ScenarioObject> live;
+    std::vector<double> buffer_us, image_us;
+    size_t live_bytes = 0, largest = 0, initial_largest = 0;
+    int failed_allocations = 0, error;
+
+    error = probe_largest_buffer(context, queue, device_id,
+                                 max_individual_size, &initial_largest);
+    if (error) return error;
+    log_info("\tRandom allocations within %gMB, largest buffer at start "
+             "%gMB.\n",
+             toMB(budget), toMB(initial_largest));
+
+    for (int step = 1; step <= steps && error != FAILED_ABORT; step++)
+    {
+        double log_size = log_min + random_unit(d) * (log_max - log_min);
+        size_t size = (size_t)exp(log_size) & ~(size_t)4095;
+        size = std::max<size_t>(SCENARIO_MIN_SIZE, size);
+
+        // The fuller the budget, the more likely a free
+        if (!live.empty()
+            && (random_unit(d) * budget < live_bytes
+                || live_bytes + size > budget))
+        {
+            size_t i = genrand_int32(d) % live.size();
+            clReleaseMemObject(live[i].mem);
+            live_bytes -= live[i].size;
+            live[i] = live.back();
+            live.pop_back();
+        }
+        else if (live_bytes + size <= budget)
+        {
+            bool image = images && genrand_int32(d) % 4 == 0;
+            ScenarioObject object = { NULL, 0 };
+            auto start = BenchmarkClock::now();
+            error = create_and_touch(context, queue, device_id, image, size,
+                                     &object.mem, &object.size);
+            double us = host_elapsed_ns(start, BenchmarkClock::now()) * 1e-3;
+            if (error == SUCCEEDED)
+            {
+                (image ? image_us : buffer_us).push_back(us);
+                live.push_back(object);
+                live_bytes += object.size;
+            }
+            else if (error == FAILED_TOO_BIG)
+            {
+                failed_allocations++;
+                error = SUCCEEDED;
+            }
+        }
+
+        if (error == SUCCEEDED && step % probe_interval == 0)
+        {
+            error = probe_largest_buffer(context, queue, device_id,
+                                         max_individual_size, &largest);
+            log_info("\tFRAGMENTATION step %d objects %zu live_MB %.1f "
+                     "largest_MB %.1f\n",
+                     step, live.size(), toMB(live_bytes), toMB(largest));
+        }
+    }
+
+    for (ScenarioObject &object : live) clReleaseMemObject(object.mem);
+    if (error == FAILED_ABORT)
+    {
+        log_error("\tAllocation scenario aborted.\n");
+        return FAILED_ABORT;
+    }
+
+    report_latency("buffer", buffer_us);
+    report_latency("image2d", image_us);
+    log_info("\t%d allocations failed for lack of memory.\n",
+             failed_allocations);
+
+    // With everything freed the allocator should be back where it started
+    error = probe_largest_buffer(context, queue, device_id,
+                                 max_individual_size, &largest);
+    if (error) return error;
+    // Nothing requires the allocator to give back everything it had before,
+    // so how much it recovers is only reported
+    log_info("\tFRAGMENTATION_RECOVERY largest_MB_start %.1f largest_MB_end "
+             "%.1f ratio %.2f\n",
+             toMB(initial_largest), toMB(largest),
+             initial_largest ? (double)largest / initial_largest : 1.0);
+    return SUCCEEDED;
+}
@@ -0,0 +1,30 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _allocation_scenarios_h
+#define _allocation_scenarios_h
+
+#include "testBase.h"
+#include "allocation_utils.h"
+
+// Runs steps random allocations and frees of buffers and read-only images
+// whose live total stays within budget bytes, and reports the allocation
+// latency and how the largest buffer that can still be allocated changes.
+int run_fragmentation_scenario(cl_context context, cl_command_queue *queue,
+                               cl_device_id device_id, size_t budget,
+                               size_t max_individual_size, int steps,
+                               MTdata d);
+
+#endif // _allocation_scenarios_h
@@ -19,6 +19,10 @@
 #include "testBase.h"
 
 extern cl_uint checksum;
+extern int g_chunked_fill;
+
+// Bytes each thread pool job maps when filling or checking in chunks
+#define CHUNKED_FILL_SIZE (8 * 1024 * 1024)
 
 int check_allocation_error(cl_context context, cl_device_id device_id,
                            int error, cl_command_queue *queue,
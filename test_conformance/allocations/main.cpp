@@ -18,8 +18,10 @@
 #include "allocation_functions.h"
 #include "allocation_fill.h"
 #include "allocation_execute.h"
+#include "allocation_scenarios.h"
 #include "harness/testHarness.h"
 #include "harness/parseParameters.h"
+#include "harness/benchmarkHelpers.h"
 #include <time.h>
 
 typedef long long unsigned llu;
@@ -33,6 +35,8 @@ int g_reduction_percentage = REDUCTION_PERCENTAGE_DEFAULT;
 int g_write_allocations = 1;
 int g_multiple_allocations = 0;
 int g_execute_kernel = 1;
+int g_fragmentation_steps = 2000;
+int g_chunked_fill = 0;
 
 static size_t g_max_size;
 static RandomSeed g_seed(gRandomSeed);
@@ -299,6 +303,32 @@ REGISTER_TEST(image2d_write_non_blocking)
 {
     return doTest(device, context, queue, IMAGE_WRITE_NON_BLOCKING);
 }
+REGISTER_TEST(fragmentation)
+{
+    if (!gBenchmark)
+    {
+        log_info("Skipping, the fragmentation test only runs with "
+                 "'--benchmark'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    double reduction = (double)g_reduction_percentage / 100.0;
+    size_t budget = (size_t)(g_global_mem_size * reduction);
+    size_t max_individual_size =
+        (size_t)(g_max_individual_allocation_size * reduction);
+
+    int failure_counts = 0;
+    for (int count = 0; count < g_repetition_count; count++)
+    {
+        log_info("  => Scenario %d\n", count + 1);
+        if (run_fragmentation_scenario(context, &queue, device, budget,
+                                       max_individual_size,
+                                       g_fragmentation_steps, g_seed)
+            != SUCCEEDED)
+            failure_counts++;
+    }
+    return failure_counts;
+}
 
 int main(int argc, const char *argv[])
 {
@@ -354,6 +384,16 @@ int main(int argc, const char *argv[])
             g_execute_kernel = 0;
         }
 
+        else if (strcmp(argv[i], "chunked_fill") == 0)
+        {
+            g_chunked_fill = 1;
+        }
+
+        else if (strncmp(argv[i], "fragmentation_steps=", 20) == 0)
+        {
+            g_fragmentation_steps = (int)strtol(argv[i] + 20, NULL, 10);
+        }
+
         else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
         {
             printUsage(argv[0]);
@@ -401,6 +441,11 @@ void printUsage(const char *execName)
              "verify its checksum.\n");
     log_info("\tdo_not_execute - Disable executing a kernel that accesses all "
              "of the memory objects.\n");
+    log_info("\tchunked_fill - Fill and check memory objects in place, in "
+             "chunks mapped in parallel by the thread pool.\n");
+    log_info("\tfragmentation_steps=<n> - Number of random allocations and "
+             "frees done by the fragmentation test, which only runs with "
+             "'--benchmark' (defaults to 2000)\n");
     log_info("\n");
     log_info("Test names (Allocation Types):\n");
     for (int i = 0; i < test_registry::getInstance().num_tests(); i++)
@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/alloc.h"
+#include "harness/benchmarkHelpers.h"
+#include "harness/errorHelpers.h"
+
+#include "testBase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+enum TransferPath
+{
+    kPathRead,
+    kPathWrite,
+    kPathCopy,
+    kPathFill,
+    kPathMapRead,
+    kPathMapWrite,
+    kNumPaths
+};
+
+const char *path_names[kNumPaths] = { "read", "write",   "copy",
+                                      "fill", "map_read", "map_write" };
+
+const cl_mem_flags benchmark_flags[] = { 0, CL_MEM_ALLOC_HOST_PTR,
+                                         CL_MEM_USE_HOST_PTR };
+const char *benchmark_flag_names[] = { "0", "CL_MEM_ALLOC_HOST_PTR",
+                                       "CL_MEM_USE_HOST_PTR" };
+
+// Byte offsets into the buffers and the host memory, from page aligned down
+// to the 4 byte alignment fills need.
+const size_t benchmark_offsets[] = { 0, 64, 4 };
+const size_t kMaxOffset = 64;
+const size_t kPageSize = 4096;
+
+typedef std::unique_ptr<void, void (*)(void *)> HostMemory;
+
+struct BenchmarkBuffers
+{
+    cl_mem_flags flags;
+    size_t size;
+    size_t offset;
+    char *host;
+    clMemWrapper src;
+    clMemWrapper dst;
+};
+
+// Runs one transfer and sets ns to its device time. A mapped transfer is timed
+// from the start of the map to the end of the unmap and includes the host copy
+// in between.
+int run_transfer(cl_command_queue queue, TransferPath path,
+                 BenchmarkBuffers &b, cl_ulong &ns)
+{
+    clEventWrapper first, last;
+    const cl_uint pattern = 0xA5A5A5A5;
+    void *mapped = NULL;
+    int error = CL_SUCCESS;
+
+    switch (path)
+    {
+        case kPathRead:
+            error = clEnqueueReadBuffer(queue, b.src, CL_TRUE, b.offset,
+                                        b.size, b.host + b.offset, 0, NULL,
+                                        &first);
+            break;
+        case kPathWrite:
+            error = clEnqueueWriteBuffer(queue, b.src, CL_TRUE, b.offset,
+                                         b.size, b.host + b.offset, 0, NULL,
+                                         &first);
+            break;
+        case kPathCopy:
+            error = clEnqueueCopyBuffer(queue, b.src, b.dst, b.offset,
+                                        b.offset, b.size, 0, NULL, &first);
+            break;
+        case kPathFill:
+            error = clEnqueueFillBuffer(queue, b.src, &pattern,
+                                        sizeof(pattern), b.offset, b.size, 0,
+                                        NULL, &first);
+            break;
+        case kPathMapRead:
+        case kPathMapWrite:
+            mapped = clEnqueueMapBuffer(
+                queue, b.src, CL_TRUE,
+                path == kPathMapRead ? CL_MAP_READ
+                                     : CL_MAP_WRITE_INVALIDATE_REGION,
+                b.offset, b.size, 0, NULL, &first, &error);
+            if (error) break;
+            if (path == kPathMapRead)
+                memcpy(b.host + b.offset, mapped, b.size);
+            else
+                memcpy(mapped, b.host + b.offset, b.size);
+            error = clEnqueueUnmapMemObject(queue, b.src, mapped, 0, NULL,
+                                            &last);
+            break;
+        default: break;
+    }
+    if (error == CL_SUCCESS) error = clFinish(queue);
+    test_error(error, "Transfer failed");
+    return get_event_elapsed_ns(first, last ? (cl_event)last : (cl_event)first,
+                                ns);
+}
+
+// hostMemory holds three page aligned regions of stride bytes: the storage of
+// the two buffers when they use a host pointer, and the host side of the
+// transfers.
+int create_buffers(cl_context context, BenchmarkBuffers &b, char *hostMemory,
+                   size_t stride)
+{
+    const size_t allocSize = b.size + kMaxOffset;
+    const bool useHostPtr = (b.flags & CL_MEM_USE_HOST_PTR) != 0;
+    int error;
+    b.host = hostMemory + 2 * stride;
+    b.src = clCreateBuffer(context, CL_MEM_READ_WRITE | b.flags, allocSize,
+                           useHostPtr ? hostMemory : NULL, &error);
+    test_error(error, "Unable to create source buffer");
+    b.dst = clCreateBuffer(context, CL_MEM_READ_WRITE | b.flags, allocSize,
+                           useHostPtr ? hostMemory + stride : NULL, &error);
+    test_error(error, "Unable to create destination buffer");
+    return CL_SUCCESS;
+}
+
+}
+
+REGISTER_TEST(buffer_benchmark)
+{
+    if (!gBenchmark)
+    {
+        log_info("Skipping, the transfer benchmark only runs with "
+                 "'--benchmark'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    std::vector<size_t> sizes;
+    int error = get_benchmark_sizes(device, kPageSize, kMaxOffset, sizes);
+    if (error) return error;
+
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    const size_t stride =
+        (sizes.back() + kMaxOffset + kPageSize - 1) / kPageSize * kPageSize;
+    HostMemory hostMemory(align_malloc(3 * stride, kPageSize), align_free);
+    if (!hostMemory)
+    {
+        log_error("ERROR: unable to allocate %zu bytes of host memory\n",
+                  3 * stride);
+        return -1;
+    }
+    memset(hostMemory.get(), 0x5A, 3 * stride);
+
+    log_info("BANDWIDTH path flags bytes offset best_GB/s median_GB/s\n");
+    for (size_t f = 0; f < ARRAY_SIZE(benchmark_flags); f++)
+    {
+        for (size_t size : sizes)
+        {
+            BenchmarkBuffers b;
+            b.flags = benchmark_flags[f];
+            b.size = size;
+            error = create_buffers(context, b, (char *)hostMemory.get(),
+                                   stride);
+            if (error) return error;
+
+            for (size_t offset : benchmark_offsets)
+            {
+                b.offset = offset;
+                for (int p = 0; p < kNumPaths; p++)
+                {
+                    std::vector<cl_ulong> times;
+                    for (int r = 0; r <= benchmark_samples(); r++)
+                    {
+                        cl_ulong ns;
+                        error = run_transfer(profilingQueue, (TransferPath)p,
+                                             b, ns);
+                        if (error) return error;
+                        if (r > 0) times.push_back(ns);
+                    }
+                    std::sort(times.begin(), times.end());
+                    log_info("BANDWIDTH %s %s %zu %zu %.3f %.3f\n",
+                             path_names[p], benchmark_flag_names[f], size,
+                             offset, (double)size / times.front(),
+                             (double)size / times[times.size() / 2]);
+                }
+            }
+        }
+    }
+    return 0;
+}
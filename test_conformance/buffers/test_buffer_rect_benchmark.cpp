@@ -0,0 +1,345 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/benchmarkHelpers.h"
+#include "harness/errorHelpers.h"
+
+#include "testBase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+enum RectPath
+{
+    kRectCopy,
+    kRectRead,
+    kRectWrite,
+    kNumRectPaths
+};
+
+const char *rect_path_names[kNumRectPaths] = { "copy_rect", "read_rect",
+                                               "write_rect" };
+
+// Bytes per row and number of slices, the rows fill the rest of the region
+struct RegionShape
+{
+    const char *name;
+    size_t width;
+    size_t depth;
+};
+
+const RegionShape region_shapes[] = {
+    { "rows_64k", 65536, 1 }, { "rows_4k", 4096, 1 },
+    { "rows_256", 256, 1 },   { "rows_16", 16, 1 },
+    { "slices_4k", 4096, 64 }, { "slices_256", 256, 64 },
+};
+
+enum PitchVariant
+{
+    kPitchTight,
+    kPitchRowPad64,
+    kPitchRowPadPage,
+    kPitchRowDouble,
+    kPitchSlicePadPage,
+    kNumPitchVariants
+};
+
+const char *pitch_variant_names[kNumPitchVariants] = {
+    "tight", "row_pad_64", "row_pad_4k", "row_double", "slice_pad_4k"
+};
+
+// Bytes moved by every transfer, unless --benchmark-max-size is smaller
+const size_t kRegionSize = 16 * 1024 * 1024;
+
+// Pitches that would spread the region over more than this many times its
+// size are skipped
+const size_t kMaxSpread = 8;
+
+struct RectConfig
+{
+    size_t region[3];
+    size_t rowPitch;
+    size_t slicePitch;
+    size_t footprint; // bytes from the first to the last byte of the region
+};
+
+bool make_config(const RegionShape &shape, PitchVariant variant,
+                 size_t regionSize, RectConfig &c)
+{
+    c.region[0] = shape.width;
+    c.region[2] = shape.depth;
+    c.region[1] = regionSize / (shape.width * shape.depth);
+    if (c.region[1] == 0) return false;
+
+    c.rowPitch = shape.width;
+    if (variant == kPitchRowPad64) c.rowPitch += 64;
+    if (variant == kPitchRowPadPage) c.rowPitch += 4096;
+    if (variant == kPitchRowDouble) c.rowPitch *= 2;
+    c.slicePitch = c.rowPitch * c.region[1];
+    if (variant == kPitchSlicePadPage)
+    {
+        if (shape.depth == 1) return false;
+        c.slicePitch += 4096;
+    }
+    c.footprint = c.slicePitch * (c.region[2] - 1)
+        + c.rowPitch * (c.region[1] - 1) + c.region[0];
+    return c.footprint <= kMaxSpread * regionSize;
+}
+
+// Runs one rectangular transfer, or a contiguous one of the same size when
+// c is NULL, and sets ns to its device time.
+int run_transfer(cl_command_queue queue, RectPath path, cl_mem src, cl_mem dst,
+                 void *host, const RectConfig *c, size_t regionSize,
+                 cl_ulong &ns)
+{
+    const size_t origin[3] = { 0, 0, 0 };
+    clEventWrapper event;
+    int error = CL_SUCCESS;
+    switch (path)
+    {
+        case kRectCopy:
+            error = c ? clEnqueueCopyBufferRect(
+                        queue, src, dst, origin, origin, c->region,
+                        c->rowPitch, c->slicePitch, c->rowPitch,
+                        c->slicePitch, 0, NULL, &event)
+                      : clEnqueueCopyBuffer(queue, src, dst, 0, 0,
+                                            regionSize, 0, NULL, &event);
+            break;
+        case kRectRead:
+            error = c ? clEnqueueReadBufferRect(
+                        queue, src, CL_TRUE, origin, origin, c->region,
+                        c->rowPitch, c->slicePitch, c->rowPitch,
+                        c->slicePitch, host, 0, NULL, &event)
+                      : clEnqueueReadBuffer(queue, src, CL_TRUE, 0,
+                                            regionSize, host, 0, NULL, &event);
+            break;
+        case kRectWrite:
+            error = c ? clEnqueueWriteBufferRect(
+                        queue, dst, CL_TRUE, origin, origin, c->region,
+                        c->rowPitch, c->slicePitch, c->rowPitch,
+                        c->slicePitch, host, 0, NULL, &event)
+                      : clEnqueueWriteBuffer(queue, dst, CL_TRUE, 0,
+                                             regionSize, host, 0, NULL,
+                                             &event);
+            break;
+        default: break;
+    }
+    if (error == CL_SUCCESS) error = clFinish(queue);
+    test_error(error, "Transfer failed");
+    return get_event_elapsed_ns(event, ns);
+}
+
+// Sets median to the median device time of a transfer
+int median_time(cl_command_queue queue, RectPath path, cl_mem src, cl_mem dst,
+                void *host, const RectConfig *c, size_t regionSize,
+                cl_ulong &median)
+{
+    std::vector<cl_ulong> times;
+    for (int r = 0; r <= benchmark_samples(); r++)
+    {
+        cl_ulong ns;
+        int error =
+            run_transfer(queue, path, src, dst, host, c, regionSize, ns);
+        if (error) return error;
+        if (r > 0) times.push_back(ns);
+    }
+    std::sort(times.begin(), times.end());
+    median = sorted_percentile(times, 50);
+    return CL_SUCCESS;
+}
+
+// Checks every row of the region, laid out in data with the pitches of c,
+// against the same row of expected
+int check_rows(const char *path, const cl_uchar *data, const RectConfig &c,
+               const cl_uchar *expected)
+{
+    for (size_t z = 0; z < c.region[2]; z++)
+    {
+        for (size_t y = 0; y < c.region[1]; y++)
+        {
+            size_t offset = z * c.slicePitch + y * c.rowPitch;
+            if (memcmp(&data[offset], &expected[offset], c.region[0]))
+            {
+                log_error("ERROR: %s row %zu of slice %zu is wrong (row "
+                          "pitch %zu, slice pitch %zu)\n",
+                          path, y, z, c.rowPitch, c.slicePitch);
+                return -1;
+            }
+        }
+    }
+    return CL_SUCCESS;
+}
+
+// Runs every path once more into a cleared destination and checks the rows
+// against the source pattern: copy_rect and write_rect through a read-back of
+// the destination sub-buffer, read_rect in host memory. parentOffset is where
+// the sub-buffers start in their parents.
+int verify_transfers(cl_command_queue queue, cl_mem src, cl_mem dst,
+                     const RectConfig &c, const std::vector<cl_uchar> &pattern,
+                     size_t parentOffset, std::vector<cl_uchar> &host,
+                     std::vector<cl_uchar> &readback)
+{
+    const cl_uchar *expected = &pattern[parentOffset];
+    const cl_uchar zero = 0;
+    cl_ulong ns;
+
+    int error = clEnqueueFillBuffer(queue, dst, &zero, sizeof(zero), 0,
+                                    c.footprint, 0, NULL, NULL);
+    test_error(error, "clEnqueueFillBuffer failed");
+    error = run_transfer(queue, kRectCopy, src, dst, NULL, &c, 0, ns);
+    if (error) return error;
+    error = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0, c.footprint,
+                                readback.data(), 0, NULL, NULL);
+    test_error(error, "clEnqueueReadBuffer failed");
+    error = check_rows(rect_path_names[kRectCopy], readback.data(), c,
+                       expected);
+    if (error) return error;
+
+    memset(host.data(), 0, c.footprint);
+    error = run_transfer(queue, kRectRead, src, dst, host.data(), &c, 0, ns);
+    if (error) return error;
+    error = check_rows(rect_path_names[kRectRead], host.data(), c, expected);
+    if (error) return error;
+
+    // host now holds the pattern rows read_rect brought back
+    error = clEnqueueFillBuffer(queue, dst, &zero, sizeof(zero), 0,
+                                c.footprint, 0, NULL, NULL);
+    test_error(error, "clEnqueueFillBuffer failed");
+    error = run_transfer(queue, kRectWrite, src, dst, host.data(), &c, 0, ns);
+    if (error) return error;
+    error = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0, c.footprint,
+                                readback.data(), 0, NULL, NULL);
+    test_error(error, "clEnqueueReadBuffer failed");
+    return check_rows(rect_path_names[kRectWrite], readback.data(), c,
+                      expected);
+}
+
+}
+
+REGISTER_TEST(buffer_rect_benchmark)
+{
+    if (!gBenchmark)
+    {
+        log_info("Skipping, the rect transfer benchmark only runs with "
+                 "'--benchmark'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    cl_ulong maxAlloc, globalMem;
+    cl_uint alignBits;
+    int error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                                sizeof(maxAlloc), &maxAlloc, NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE,
+                             sizeof(globalMem), &globalMem, NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_MEM_BASE_ADDR_ALIGN,
+                             sizeof(alignBits), &alignBits, NULL);
+    test_error(error, "Unable to get device memory properties");
+
+    // Sub-buffers start at the start of their parents and at two aligned
+    // offsets
+    const size_t align = alignBits / 8;
+    const size_t sub_offsets[] = { 0, align, 3 * align };
+
+    // The two buffers each hold the most spread out region past the largest
+    // offset, leave room for the rest of the device
+    size_t regionSize = kRegionSize;
+    if (gBenchmarkMaxSize)
+        regionSize = std::min(regionSize, (size_t)gBenchmarkMaxSize);
+    while (regionSize > 4096
+           && (kMaxSpread * regionSize + 3 * align > maxAlloc
+               || 2 * (kMaxSpread * regionSize + 3 * align) > globalMem / 2))
+        regionSize /= 2;
+    const size_t parentSize = kMaxSpread * regionSize + 3 * align;
+
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+    clMemWrapper srcParent = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                            parentSize, NULL, &error);
+    test_error(error, "Unable to create source buffer");
+    clMemWrapper dstParent = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                            parentSize, NULL, &error);
+    test_error(error, "Unable to create destination buffer");
+
+    std::vector<cl_uchar> pattern(parentSize), readback(parentSize);
+    for (size_t i = 0; i < parentSize; i++)
+        pattern[i] = (cl_uchar)(i * 31 + i / 4093);
+    // Source of write_rect, and destination of read_rect
+    std::vector<cl_uchar> host(pattern);
+    error = clEnqueueWriteBuffer(profilingQueue, srcParent, CL_TRUE, 0,
+                                 parentSize, pattern.data(), 0, NULL, NULL);
+    test_error(error, "Unable to initialize source buffer");
+
+    // Contiguous transfers of regionSize bytes are the reference
+    cl_ulong contiguous[kNumRectPaths];
+    for (int p = 0; p < kNumRectPaths; p++)
+    {
+        error = median_time(profilingQueue, (RectPath)p, srcParent,
+                            dstParent, host.data(), NULL, regionSize,
+                            contiguous[p]);
+        if (error) return error;
+    }
+
+    log_info("RECT path shape pitch sub_offset width height depth row_pitch "
+             "slice_pitch bytes GB/s ratio_to_contiguous\n");
+    for (const RegionShape &shape : region_shapes)
+    {
+        for (int v = 0; v < kNumPitchVariants; v++)
+        {
+            RectConfig c;
+            if (!make_config(shape, (PitchVariant)v, regionSize, c)) continue;
+            // The rows do not always divide regionSize evenly
+            const size_t bytes = c.region[0] * c.region[1] * c.region[2];
+
+            for (size_t offset : sub_offsets)
+            {
+                cl_buffer_region subRegion = { offset, c.footprint };
+                clMemWrapper src = clCreateSubBuffer(
+                    srcParent, CL_MEM_READ_WRITE,
+                    CL_BUFFER_CREATE_TYPE_REGION, &subRegion, &error);
+                test_error(error, "Unable to create source sub-buffer");
+                clMemWrapper dst = clCreateSubBuffer(
+                    dstParent, CL_MEM_READ_WRITE,
+                    CL_BUFFER_CREATE_TYPE_REGION, &subRegion, &error);
+                test_error(error, "Unable to create destination sub-buffer");
+
+                for (int p = 0; p < kNumRectPaths; p++)
+                {
+                    cl_ulong ns;
+                    error = median_time(profilingQueue, (RectPath)p, src, dst,
+                                        host.data(), &c, 0, ns);
+                    if (error) return error;
+                    double rate = (double)bytes / ns;
+                    log_info("RECT %s %s %s %zu %zu %zu %zu %zu %zu %zu "
+                             "%.3f %.3f\n",
+                             rect_path_names[p], shape.name,
+                             pitch_variant_names[v], offset, c.region[0],
+                             c.region[1], c.region[2], c.rowPitch,
+                             c.slicePitch, bytes, rate,
+                             rate * contiguous[p] / regionSize);
+                }
+
+                error = verify_transfers(profilingQueue, src, dst, c,
+                                         pattern, offset, host, readback);
+                if (error) return error;
+            }
+        }
+    }
+    return 0;
+}
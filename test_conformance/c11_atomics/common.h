@@ -72,6 +72,12 @@ extern int gInternalIterations; // internal test iterations for atomic
                                 // operation, sufficient to verify atomicity
 extern int
     gMaxDeviceThreads; // maximum number of threads executed on OCL device
+extern bool gStress; // run the contention stress test
+extern int gStressIterations; // atomic adds per work-item in the stress test
+extern cl_uint gStressWorkItems; // fixed stress work-items, 0 to sweep
+extern cl_uint gStressContention; // fixed stress work-items per location,
+                                  // 0 to sweep
+extern int gStressSeconds; // duration of each host/device interop stress run
 extern cl_device_atomic_capabilities gAtomicMemCap,
     gAtomicFenceCap; // atomic memory and fence capabilities for this device
 extern cl_half_rounding_mode gHalfRoundingMode;
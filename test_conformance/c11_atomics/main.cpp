@@ -29,6 +29,11 @@ bool gUseHostPtr = false; // use malloc/free with CL_MEM_USE_HOST_PTR instead of
 bool gDebug = false; // always print OpenCL kernel code
 int gInternalIterations = 10000; // internal test iterations for atomic operation, sufficient to verify atomicity
 int gMaxDeviceThreads = 1024; // maximum number of threads executed on OCL device
+bool gStress = false; // run the contention stress test
+int gStressIterations = 64; // atomic adds per work-item in the stress test
+cl_uint gStressWorkItems = 0; // fixed stress work-items, 0 to sweep
+cl_uint gStressContention = 0; // fixed stress work-items per location, 0 to sweep
+int gStressSeconds = 2; // duration of each host/device interop stress run
 cl_device_atomic_capabilities gAtomicMemCap,
     gAtomicFenceCap; // atomic memory and fence capabilities for this device
 cl_half_rounding_mode gHalfRoundingMode = CL_HALF_RTE;
@@ -176,7 +181,12 @@ int main(int argc, const char *argv[])
       log_info("  '-useHostPtr'              use malloc/free with CL_MEM_USE_HOST_PTR instead of clSVMAlloc/clSVMFree\n");
       log_info("  '-debug'                   always print OpenCL kernel code\n");
       log_info("  '-internalIterations <X>'  internal test iterations for atomic operation, sufficient to verify atomicity\n");
-      log_info("  '-maxDeviceThreads <X>'    maximum number of threads executed on OCL device");
+      log_info("  '-maxDeviceThreads <X>'    maximum number of threads executed on OCL device\n");
+      log_info("  '-stress'                  run the atomic stress tests, which report throughput\n");
+      log_info("  '-stressIterations <X>'    atomic adds per work-item in the stress test (default 64)\n");
+      log_info("  '-stressWorkItems <X>'     stress test work-items (default: sweep 1K, 16K, 256K)\n");
+      log_info("  '-stressContention <X>'    stress test work-items per location (default: sweep 1 to all)\n");
+      log_info("  '-stressSeconds <X>'       duration of each host/device interop stress run (default 2)\n");
 
       break;
     }
@@ -229,6 +239,33 @@ int main(int argc, const char *argv[])
       argc--;
       noCert = true;
     }
+    else if(std::string(argv[argc-1]) == "-stress") // run the contention stress test
+      gStress = true;
+    else if(argc > 2 && std::string(argv[argc-2]) == "-stressIterations") // atomic adds per work-item in the stress test
+    {
+      gStressIterations = atoi(argv[argc-1]);
+      if(gStressIterations < 1)
+      {
+        log_info("Invalid value: Number of stress iterations (%d) must be > 0\n", gStressIterations);
+        return -1;
+      }
+      argc--;
+    }
+    else if(argc > 2 && std::string(argv[argc-2]) == "-stressWorkItems") // stress test work-items
+    {
+      gStressWorkItems = (cl_uint)strtoul(argv[argc-1], NULL, 0);
+      argc--;
+    }
+    else if(argc > 2 && std::string(argv[argc-2]) == "-stressContention") // stress test work-items per location
+    {
+      gStressContention = (cl_uint)strtoul(argv[argc-1], NULL, 0);
+      argc--;
+    }
+    else if(argc > 2 && std::string(argv[argc-2]) == "-stressSeconds") // duration of each host/device interop stress run
+    {
+      gStressSeconds = atoi(argv[argc-1]);
+      argc--;
+    }
     else
       break;
     argc--;
@@ -0,0 +1,559 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/testHarness.h"
+#include "harness/kernelHelpers.h"
+#include "harness/typeWrappers.h"
+
+#include "common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Work-item counts and work-items per location swept when they are not fixed
+// on the command line. A contention of 0 means all work-items share a single
+// location.
+const cl_uint kStressWorkItems[] = { 1U << 10, 1U << 14, 1U << 18 };
+const cl_uint kStressContention[] = { 1, 8, 64, 512, 0 };
+
+struct StressConfig
+{
+    TExplicitMemoryOrderType order;
+    TExplicitMemoryScopeType scope;
+    cl_uint workItems;
+    cl_uint contention;
+};
+
+std::string stress_name(TExplicitMemoryOrderType order,
+                        TExplicitMemoryScopeType scope)
+{
+    if (order == MEMORY_ORDER_EMPTY) return "implicit";
+    std::string name = std::string(get_memory_order_type_name(order))
+                           .substr(strlen("memory_order_"));
+    if (scope != MEMORY_SCOPE_EMPTY)
+        name += std::string(", ")
+            + std::string(get_memory_scope_type_name(scope))
+                  .substr(strlen("memory_scope_"));
+    return name;
+}
+
+// Every work-item adds 1 to its location iterations times and sums the old
+// values it gets back. With n adds to one location the old values seen there
+// are exactly 0 .. n - 1, so both the final value and the sum of the old
+// values are known without replaying the adds on the host.
+std::string stress_source(TExplicitMemoryOrderType order,
+                          TExplicitMemoryScopeType scope)
+{
+    std::string call = "atomic_fetch_add(p, 1u)";
+    if (order != MEMORY_ORDER_EMPTY)
+    {
+        call = std::string("atomic_fetch_add_explicit(p, 1u, ")
+            + get_memory_order_type_name(order);
+        if (scope != MEMORY_SCOPE_EMPTY)
+            call += std::string(", ") + get_memory_scope_type_name(scope);
+        call += ")";
+    }
+    return "__kernel void stress(volatile __global atomic_uint *dst,\n"
+           "                     __global ulong *oldSums, uint contention,\n"
+           "                     uint iterations)\n"
+           "{\n"
+           "    size_t tid = get_global_id(0);\n"
+           "    volatile __global atomic_uint *p = dst + tid / contention;\n"
+           "    ulong sum = 0;\n"
+           "    for (uint i = 0; i < iterations; i++)\n"
+           "        sum += "
+        + call
+        + ";\n"
+          "    oldSums[tid] = sum;\n"
+          "}\n";
+}
+
+// Location i got adds[i] increments of 1 and the old values returned by them
+// sum up to sums[i]
+int stress_check(const volatile cl_uint *finalValues,
+                 const std::vector<cl_ulong> &adds,
+                 const std::vector<cl_ulong> &sums)
+{
+    int errors = 0;
+    for (size_t loc = 0; loc < adds.size(); loc++)
+    {
+        cl_ulong n = adds[loc];
+        if (finalValues[loc] == n && sums[loc] == n * (n - 1) / 2) continue;
+        if (errors++ < 10)
+            log_error("ERROR: location %zu: final value %u (expected %" PRIu64
+                      "), sum of old values %" PRIu64 " (expected %" PRIu64
+                      ")\n",
+                      loc, finalValues[loc], n, sums[loc], n * (n - 1) / 2);
+    }
+    if (errors)
+        log_error("ERROR: %d of %zu locations are wrong\n", errors,
+                  adds.size());
+    return errors ? -1 : 0;
+}
+
+int stress_verify(const StressConfig &config,
+                  const std::vector<cl_uint> &finalValues,
+                  const std::vector<cl_ulong> &oldSums)
+{
+    std::vector<cl_ulong> adds(finalValues.size()), sums(finalValues.size());
+    for (size_t tid = 0; tid < config.workItems; tid++)
+    {
+        adds[tid / config.contention] += gStressIterations;
+        sums[tid / config.contention] += oldSums[tid];
+    }
+    return stress_check(finalValues.data(), adds, sums);
+}
+
+int stress_run(cl_context context, cl_command_queue queue, cl_kernel kernel,
+               size_t localSize, const StressConfig &config)
+{
+    const size_t numLocations =
+        (config.workItems + config.contention - 1) / config.contention;
+    int error;
+
+    clMemWrapper dst = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                      numLocations * sizeof(cl_uint), NULL,
+                                      &error);
+    test_error(error, "Unable to create destination buffer");
+    clMemWrapper oldSums =
+        clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                       config.workItems * sizeof(cl_ulong), NULL, &error);
+    test_error(error, "Unable to create old value buffer");
+
+    cl_uint iterations = gStressIterations;
+    error = clSetKernelArg(kernel, 0, sizeof(dst), &dst);
+    error |= clSetKernelArg(kernel, 1, sizeof(oldSums), &oldSums);
+    error |= clSetKernelArg(kernel, 2, sizeof(config.contention),
+                            &config.contention);
+    error |= clSetKernelArg(kernel, 3, sizeof(iterations), &iterations);
+    test_error(error, "Unable to set kernel arguments");
+
+    // The first launch only warms up the kernel, the second one is timed and
+    // verified.
+    size_t globalSize = config.workItems;
+    clEventWrapper event;
+    for (int run = 0; run < 2; run++)
+    {
+        const cl_uint zero = 0;
+        error = clEnqueueFillBuffer(queue, dst, &zero, sizeof(zero), 0,
+                                    numLocations * sizeof(cl_uint), 0, NULL,
+                                    NULL);
+        test_error(error, "Unable to clear destination buffer");
+        event = NULL;
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize,
+                                       &localSize, 0, NULL, &event);
+        test_error(error, "Unable to enqueue stress kernel");
+    }
+
+    std::vector<cl_uint> finalValues(numLocations);
+    std::vector<cl_ulong> oldValueSums(config.workItems);
+    error = clEnqueueReadBuffer(queue, dst, CL_FALSE, 0,
+                                numLocations * sizeof(cl_uint),
+                                finalValues.data(), 0, NULL, NULL);
+    test_error(error, "Unable to read destination buffer");
+    error = clEnqueueReadBuffer(queue, oldSums, CL_TRUE, 0,
+                                config.workItems * sizeof(cl_ulong),
+                                oldValueSums.data(), 0, NULL, NULL);
+    test_error(error, "Unable to read old value buffer");
+
+    cl_ulong start, end;
+    error = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START,
+                                    sizeof(start), &start, NULL);
+    error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,
+                                     sizeof(end), &end, NULL);
+    test_error(error, "Unable to get kernel profiling info");
+
+    error = stress_verify(config, finalValues, oldValueSums);
+
+    double seconds = (end - start) * 1e-9;
+    double ops = (double)config.workItems * iterations;
+    log_info("\t%-32s %8u work-items %8u per location %10.3f ms %12.4g ops/s"
+             "%s\n",
+             stress_name(config.order, config.scope).c_str(), config.workItems,
+             config.contention, seconds * 1e3,
+             seconds > 0 ? ops / seconds : 0.0, error ? "  FAILED" : "");
+    return error;
+}
+
+int stress_order_scope(cl_device_id device, cl_context context,
+                       cl_command_queue queue, TExplicitMemoryOrderType order,
+                       TExplicitMemoryScopeType scope)
+{
+    std::string source = stress_source(order, scope);
+    const char *sourcePtr = source.c_str();
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    int error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                            &sourcePtr, "stress");
+    test_error(error, "Unable to create stress kernel");
+
+    size_t maxLocalSize;
+    error = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE,
+                                     sizeof(maxLocalSize), &maxLocalSize, NULL);
+    test_error(error, "Unable to get kernel work-group size");
+
+    std::vector<cl_uint> workItems(std::begin(kStressWorkItems),
+                                   std::end(kStressWorkItems));
+    if (gStressWorkItems) workItems.assign(1, gStressWorkItems);
+    std::vector<cl_uint> contention(std::begin(kStressContention),
+                                    std::end(kStressContention));
+    if (gStressContention) contention.assign(1, gStressContention);
+
+    int failures = 0;
+    for (cl_uint items : workItems)
+    {
+        // Largest power of two work-group size that divides the work-items
+        size_t localSize = 1;
+        while (localSize * 2 <= maxLocalSize && items % (localSize * 2) == 0)
+            localSize *= 2;
+
+        for (cl_uint c : contention)
+        {
+            StressConfig config = { order, scope, items, c ? c : items };
+            if (config.contention > items) continue;
+
+            // Work-items sharing a location must be in one work-group when
+            // the atomics are only atomic within a work-group.
+            if (scope == MEMORY_SCOPE_WORK_GROUP
+                && localSize % config.contention != 0)
+                continue;
+
+            // The final value of a location has to fit in 32 bits
+            if ((cl_ulong)config.contention * gStressIterations > CL_UINT_MAX)
+            {
+                log_info("\tSkipping %u work-items per location, too many "
+                         "adds for 32 bit atomics\n",
+                         config.contention);
+                continue;
+            }
+
+            error = stress_run(context, queue, kernel, localSize, config);
+            if (error)
+            {
+                failures++;
+                if (!gContinueOnError) return error;
+            }
+        }
+    }
+    return failures ? -1 : 0;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+// Host operations between two queries of the kernel status
+const cl_ulong kInteropBatch = 64;
+
+struct InteropHostInfo
+{
+    volatile HOST_ATOMIC_UINT *counters;
+    cl_uint numLocations;
+    TExplicitMemoryOrderType order;
+    cl_event kernelEvent;
+    // Host operations per job that keep every location within 32 bits
+    cl_ulong maxOps;
+    std::vector<cl_ulong> oldSums;
+    std::vector<cl_ulong> ops;
+    std::vector<Clock::time_point> stopTimes;
+};
+
+// Host job j works on location j % numLocations until the kernel completes.
+// Even jobs use fetch_add and odd jobs a compare-exchange loop, so both paths
+// race with the device.
+cl_int interop_host_job(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    InteropHostInfo *info = (InteropHostInfo *)userInfo;
+    volatile HOST_ATOMIC_UINT *p =
+        info->counters + job_id % info->numLocations;
+    cl_ulong sum = 0, ops = 0;
+    for (;;)
+    {
+        cl_int status;
+        cl_int error =
+            clGetEventInfo(info->kernelEvent, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                           sizeof(status), &status, NULL);
+        test_error(error, "Unable to get the interop kernel status");
+        if (status < 0)
+        {
+            log_error("ERROR: the interop kernel failed (%s)\n",
+                      IGetErrorString(status));
+            return status;
+        }
+        if (status == CL_COMPLETE || ops + kInteropBatch > info->maxOps) break;
+
+        for (cl_ulong i = 0; i < kInteropBatch; i++)
+        {
+            if (job_id & 1)
+            {
+                HOST_UINT expected =
+                    host_atomic_load<HOST_ATOMIC_UINT, HOST_UINT>(p,
+                                                                  info->order);
+                while (!host_atomic_compare_exchange(p, &expected,
+                                                     (HOST_UINT)(expected + 1),
+                                                     info->order, info->order))
+                    ;
+                sum += expected;
+            }
+            else
+                sum += host_atomic_fetch_add(p, (HOST_UINT)1, info->order);
+        }
+        ops += kInteropBatch;
+    }
+    info->stopTimes[job_id] = Clock::now();
+    info->oldSums[job_id] = sum;
+    info->ops[job_id] = ops;
+    return CL_SUCCESS;
+}
+
+int interop_order(cl_context context, cl_command_queue queue,
+                  TExplicitMemoryOrderType order, cl_uint workItems,
+                  cl_uint contention)
+{
+    const cl_uint numLocations = (workItems + contention - 1) / contention;
+    const cl_uint hostJobs = std::max(numLocations, GetThreadCount());
+
+    std::string source = stress_source(order, MEMORY_SCOPE_ALL_SVM_DEVICES);
+    const char *sourcePtr = source.c_str();
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    int error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                            &sourcePtr, "stress");
+    test_error(error, "Unable to create interop kernel");
+
+    // The counters are shared with the host, the old value sums are not
+    cl_uint *counters = (cl_uint *)clSVMAlloc(
+        context,
+        CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER | CL_MEM_SVM_ATOMICS,
+        numLocations * sizeof(cl_uint), 0);
+    if (!counters)
+    {
+        log_error("ERROR: clSVMAlloc failed!\n");
+        return -1;
+    }
+    std::unique_ptr<cl_uint, std::function<void(cl_uint *)>> countersHolder(
+        counters, [context](cl_uint *p) { clSVMFree(context, p); });
+    clMemWrapper deviceSums =
+        clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                       workItems * sizeof(cl_ulong), NULL, &error);
+    test_error(error, "Unable to create old value buffer");
+
+    cl_uint iterations = gStressIterations;
+    error = clSetKernelArgSVMPointer(kernel, 0, counters);
+    error |= clSetKernelArg(kernel, 1, sizeof(deviceSums), &deviceSums);
+    error |= clSetKernelArg(kernel, 2, sizeof(contention), &contention);
+    error |= clSetKernelArg(kernel, 3, sizeof(iterations), &iterations);
+    test_error(error, "Unable to set kernel arguments");
+
+    const cl_uint jobsPerLocation =
+        (hostJobs + numLocations - 1) / numLocations;
+    InteropHostInfo info;
+    info.counters = (volatile HOST_ATOMIC_UINT *)counters;
+    info.numLocations = numLocations;
+    info.order = order;
+    info.maxOps =
+        (CL_UINT_MAX - (cl_ulong)contention * gStressIterations)
+        / jobsPerLocation;
+    info.oldSums.resize(hostJobs);
+    info.ops.resize(hostJobs);
+    info.stopTimes.resize(hostJobs);
+    std::vector<cl_ulong> oldSums(workItems);
+
+    // Only the time from the start of the host jobs until the first of them
+    // sees the kernel complete counts, each round is verified afterwards.
+    // Rounds in which the kernel completed before any host operation ran do
+    // not overlap and add nothing.
+    Clock::duration overlap(0);
+    cl_ulong overlapOps = 0, hostOps = 0;
+    const auto end = Clock::now() + std::chrono::seconds(gStressSeconds);
+    cl_uint rounds = 0;
+    do
+    {
+        for (cl_uint loc = 0; loc < numLocations; loc++) counters[loc] = 0;
+
+        size_t globalSize = workItems;
+        clEventWrapper kernelEvent;
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize,
+                                       NULL, 0, NULL, &kernelEvent);
+        test_error(error, "Unable to enqueue interop kernel");
+        error = clFlush(queue);
+        test_error(error, "clFlush failed");
+        info.kernelEvent = kernelEvent;
+        auto start = Clock::now();
+        error = ThreadPool_Do(interop_host_job, hostJobs, &info);
+        test_error(error, "Unable to run host threads");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+
+        cl_ulong roundOps = 0;
+        for (cl_ulong ops : info.ops) roundOps += ops;
+        if (roundOps)
+        {
+            auto stop = *std::min_element(info.stopTimes.begin(),
+                                          info.stopTimes.end());
+            if (stop > start) overlap += stop - start;
+            overlapOps += roundOps + (cl_ulong)workItems * gStressIterations;
+            hostOps += roundOps;
+        }
+
+        error = clEnqueueReadBuffer(queue, deviceSums, CL_TRUE, 0,
+                                    workItems * sizeof(cl_ulong),
+                                    oldSums.data(), 0, NULL, NULL);
+        test_error(error, "Unable to read old value buffer");
+
+        std::vector<cl_ulong> adds(numLocations), sums(numLocations);
+        for (cl_uint tid = 0; tid < workItems; tid++)
+        {
+            adds[tid / contention] += gStressIterations;
+            sums[tid / contention] += oldSums[tid];
+        }
+        for (cl_uint job = 0; job < hostJobs; job++)
+        {
+            adds[job % numLocations] += info.ops[job];
+            sums[job % numLocations] += info.oldSums[job];
+        }
+        error = stress_check(counters, adds, sums);
+        rounds++;
+    } while (!error && Clock::now() < end);
+
+    double seconds = std::chrono::duration<double>(overlap).count();
+    log_info("\t%-24s %8u work-items %6u host jobs %6u locations %5u rounds "
+             "%12" PRIu64 " host ops %12.4g ops/s%s\n",
+             stress_name(order, MEMORY_SCOPE_ALL_SVM_DEVICES).c_str(),
+             workItems, hostJobs, numLocations, rounds, hostOps,
+             seconds > 0 ? overlapOps / seconds : 0.0, error ? "  FAILED" : "");
+    return error;
+}
+
+}
+
+REGISTER_TEST(atomic_fetch_add_stress)
+{
+    if (!gStress)
+    {
+        log_info("Skipping, the contention stress test only runs with "
+                 "'-stress'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+    if (gHost || gOldAPI)
+    {
+        log_info("Skipping, the contention stress test needs the OpenCL 2.0 "
+                 "atomics on the device\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    // Use a queue of our own so the kernels can be timed
+    int error;
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    std::vector<TExplicitMemoryOrderType> memoryOrder;
+    std::vector<TExplicitMemoryScopeType> memoryScope;
+    test_error_ret(
+        getSupportedMemoryOrdersAndScopes(device, memoryOrder, memoryScope),
+        "getSupportedMemoryOrdersAndScopes failed\n", TEST_FAIL);
+
+    log_info("atomic_fetch_add on atomic_uint, %d adds per work-item\n",
+             gStressIterations);
+    int failures = 0;
+    for (TExplicitMemoryOrderType order : memoryOrder)
+    {
+        for (TExplicitMemoryScopeType scope : memoryScope)
+        {
+            if (order == MEMORY_ORDER_EMPTY && scope != MEMORY_SCOPE_EMPTY)
+                continue;
+            error = stress_order_scope(device, context, profilingQueue, order,
+                                       scope);
+            if (error)
+            {
+                failures++;
+                if (!gContinueOnError) return error;
+            }
+        }
+    }
+    return failures ? -1 : 0;
+}
+
+REGISTER_TEST(svm_atomic_interop_stress)
+{
+    if (!gStress)
+    {
+        log_info("Skipping, the host/device interop stress test only runs "
+                 "with '-stress'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+    if (gHost || gOldAPI || gUseHostPtr)
+    {
+        log_info("Skipping, the host/device interop stress test needs fine "
+                 "grain SVM atomics on the device\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    cl_device_svm_capabilities caps;
+    int error = clGetDeviceInfo(device, CL_DEVICE_SVM_CAPABILITIES,
+                                sizeof(caps), &caps, 0);
+    test_error(error, "clGetDeviceInfo failed");
+    if ((caps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER) == 0
+        || (caps & CL_DEVICE_SVM_ATOMICS) == 0
+        || (gAtomicMemCap & CL_DEVICE_ATOMIC_SCOPE_ALL_DEVICES) == 0)
+    {
+        log_info("Skipping, fine grain SVM atomics are not supported\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    std::vector<TExplicitMemoryOrderType> memoryOrder;
+    std::vector<TExplicitMemoryScopeType> memoryScope;
+    test_error_ret(
+        getSupportedMemoryOrdersAndScopes(device, memoryOrder, memoryScope),
+        "getSupportedMemoryOrdersAndScopes failed\n", TEST_FAIL);
+
+    cl_uint workItems = gStressWorkItems ? gStressWorkItems : 1U << 16;
+    cl_uint contention = gStressContention ? gStressContention : 64;
+    contention = std::min(contention, workItems);
+    cl_uint numLocations = (workItems + contention - 1) / contention;
+    cl_uint hostJobs = std::max(numLocations, GetThreadCount());
+    cl_uint hostJobsPerLocation = (hostJobs + numLocations - 1) / numLocations;
+    if ((cl_ulong)(contention + hostJobsPerLocation) * gStressIterations
+        > CL_UINT_MAX)
+    {
+        log_error("ERROR: too many adds per location for 32 bit atomics, "
+                  "lower -stressContention or -stressIterations\n");
+        return -1;
+    }
+
+    log_info("atomic_fetch_add on fine grain SVM from the device and %u host "
+             "threads, %d adds per work-item and host job, %d s per order\n",
+             GetThreadCount(), gStressIterations, gStressSeconds);
+    int failures = 0;
+    for (TExplicitMemoryOrderType order : memoryOrder)
+    {
+        // The scope has to be all SVM devices for the host to take part
+        if (order == MEMORY_ORDER_EMPTY) continue;
+        error = interop_order(context, queue, order, workItems, contention);
+        if (error)
+        {
+            failures++;
+            if (!gContinueOnError) return error;
+        }
+    }
+    return failures ? -1 : 0;
+}
@@ -74,12 +74,13 @@ int gTimeResults = 1;
 int gTimeResults = 0;
 #endif
 int gReportAverageTimes = 0;
-void *gIn = NULL;
-void *gRef = NULL;
-void *gAllowZ = NULL;
+void *gIn[kPipelineDepth] = { NULL };
+void *gRef[kPipelineDepth] = { NULL };
+void *gAllowZ[kPipelineDepth] = { NULL };
 void *gOut[kCallStyleCount] = { NULL };
-cl_mem gInBuffer;
-cl_mem gOutBuffers[kCallStyleCount];
+cl_mem gInBuffers[kPipelineDepth];
+cl_mem gOutBuffers[kPipelineDepth][kCallStyleCount];
+int gPipelineDepth = kPipelineDepth;
 size_t gComputeDevices = 0;
 uint32_t gDeviceFrequency = 0;
 int gWimpyMode = 0;
@@ -94,6 +95,11 @@ int gHasDouble = 0;
 int gTestDouble = 1;
 int gHasHalfs = 0;
 int gTestHalfs = 1;
+std::atomic<int> gSimdReference(1);
+int gExhaustive = 0;
+int gBatchPrograms = 0;
+int gShardIndex = 0;
+int gShardCount = 1;
 const char *sizeNames[] = { "", "", "2", "3", "4", "8", "16" };
 int vectorSizes[] = { 1, 1, 2, 3, 4, 8, 16 };
 int gMinVectorSize = 0;
@@ -316,12 +322,12 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
                                                                uint32_t count,
                                                                int vectorSize)
 {
-    const cl_uchar *a = (const cl_uchar *)gAllowZ;
+    const cl_uchar *a = (const cl_uchar *)parent->allowZ;
 
     if constexpr (is_half<OutType, OutFP>())
     {
         const cl_half *t = (const cl_half *)test;
-        const cl_half *c = (const cl_half *)gRef;
+        const cl_half *c = (const cl_half *)parent->ref;
 
         for (uint32_t i = 0; i < count; i++)
             if (t[i] != c[i] &&
@@ -338,7 +344,7 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
     else if constexpr (std::is_integral<OutType>::value)
     { // char/uchar/short/ushort/half/int/uint/long/ulong
         const OutType *t = (const OutType *)test;
-        const OutType *c = (const OutType *)gRef;
+        const OutType *c = (const OutType *)parent->ref;
         for (uint32_t i = 0; i < count; i++)
             if (t[i] != c[i] && !(a[i] != (cl_uchar)0 && t[i] == (OutType)0))
             {
@@ -354,7 +360,7 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
     {
         // cast to integral - from original test
         const cl_uint *t = (const cl_uint *)test;
-        const cl_uint *c = (const cl_uint *)gRef;
+        const cl_uint *c = (const cl_uint *)parent->ref;
 
         for (uint32_t i = 0; i < count; i++)
             if (t[i] != c[i] &&
@@ -365,14 +371,15 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
             {
                 vlog(
                     "\nError for vector size %d found at 0x%8.8x:  *%a vs %a\n",
-                    vectorSize, i, ((OutType *)gRef)[i], ((OutType *)test)[i]);
+                    vectorSize, i, ((OutType *)parent->ref)[i],
+                    ((OutType *)test)[i]);
                 return i + 1;
             }
     }
     else
     {
         const cl_ulong *t = (const cl_ulong *)test;
-        const cl_ulong *c = (const cl_ulong *)gRef;
+        const cl_ulong *c = (const cl_ulong *)parent->ref;
 
         for (uint32_t i = 0; i < count; i++)
             if (t[i] != c[i] &&
@@ -384,7 +391,8 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
             {
                 vlog(
                     "\nError for vector size %d found at 0x%8.8x:  *%a vs %a\n",
-                    vectorSize, i, ((OutType *)gRef)[i], ((OutType *)test)[i]);
+                    vectorSize, i, ((OutType *)parent->ref)[i],
+                    ((OutType *)test)[i]);
                 return i + 1;
             }
     }
@@ -621,6 +629,7 @@ void ConversionsTest::TestTypesConversion(const Type &inType,
                            gSaturationNames[sat], gRoundingModeNames[round],
                            gTypeNames[inType]);
             }
+            conv_test::ReportShardResult(outType, inType, sat, round, error);
         }
     }
 }
@@ -637,7 +646,11 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
 
     DataInitInfo info = { 0, 0, outType, inType, sat, round, threads };
     DataInfoSpec<InType, OutType, InFP, OutFP> init_info(info);
-    WriteInputBufferInfo writeInputBufferInfo;
+    // Ring of blocks so that generating the input and reference values of one
+    // block overlaps with the device conversion and verification of the
+    // previous ones. Not resized after this point, callbacks hold pointers
+    // into it.
+    std::vector<WriteInputBufferInfo> blocks(gPipelineDepth);
     int vectorSize;
     int error = 0;
     uint64_t i;
@@ -652,34 +665,53 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
         init_info.mdv.emplace_back(MTdataHolder(gRandomSeed));
     }
 
-    writeInputBufferInfo.outType = outType;
-    writeInputBufferInfo.inType = inType;
-
-    writeInputBufferInfo.calcInfo.resize(gMaxVectorSize);
-    for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
+    for (int b = 0; b < gPipelineDepth; b++)
     {
-        writeInputBufferInfo.calcInfo[vectorSize].reset(
-            new CalcRefValsPat<InType, OutType, InFP, OutFP>());
-        writeInputBufferInfo.calcInfo[vectorSize]->program =
-            conv_test::MakeProgram(
-                outType, inType, sat, round, vectorSize,
-                &writeInputBufferInfo.calcInfo[vectorSize]->kernel);
-        if (NULL == writeInputBufferInfo.calcInfo[vectorSize]->program)
-        {
-            gFailCount++;
-            return -1;
-        }
-        if (NULL == writeInputBufferInfo.calcInfo[vectorSize]->kernel)
+        WriteInputBufferInfo &block = blocks[b];
+        block.outType = outType;
+        block.inType = inType;
+        block.in = gIn[b];
+        block.ref = gRef[b];
+        block.allowZ = gAllowZ[b];
+        block.inBuffer = gInBuffers[b];
+        block.outBuffers = gOutBuffers[b];
+
+        block.calcInfo.resize(gMaxVectorSize);
+        for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
+             vectorSize++)
         {
-            gFailCount++;
-            vlog_error("\t\tFAILED -- Failed to create kernel.\n");
-            return -2;
-        }
+            block.calcInfo[vectorSize].reset(
+                new CalcRefValsPat<InType, OutType, InFP, OutFP>());
+            if (b == 0)
+            {
+                block.calcInfo[vectorSize]->program = conv_test::MakeProgram(
+                    outType, inType, sat, round, vectorSize,
+                    &block.calcInfo[vectorSize]->kernel);
+                if (NULL == block.calcInfo[vectorSize]->program)
+                {
+                    gFailCount++;
+                    return -1;
+                }
+                if (NULL == block.calcInfo[vectorSize]->kernel)
+                {
+                    gFailCount++;
+                    vlog_error("\t\tFAILED -- Failed to create kernel.\n");
+                    return -2;
+                }
+            }
+            else
+            {
+                // all blocks share the kernels built for the first one
+                block.calcInfo[vectorSize]->program =
+                    blocks[0].calcInfo[vectorSize]->program;
+                block.calcInfo[vectorSize]->kernel =
+                    blocks[0].calcInfo[vectorSize]->kernel;
+            }
 
-        writeInputBufferInfo.calcInfo[vectorSize]->parent =
-            &writeInputBufferInfo;
-        writeInputBufferInfo.calcInfo[vectorSize]->vectorSize = vectorSize;
-        writeInputBufferInfo.calcInfo[vectorSize]->result = -1;
+            block.calcInfo[vectorSize]->parent = &block;
+            block.calcInfo[vectorSize]->vectorSize = vectorSize;
+            block.calcInfo[vectorSize]->result = -1;
+        }
     }
 
     if (gSkipTesting) return error;
@@ -698,18 +730,121 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
             init_info.round = round = kRoundTowardZero;
     }
 
+    // Wait for the callbacks of a block to finish verifying correctness and
+    // report the first failure, if any.
+    auto retireBlock = [&](WriteInputBufferInfo &block) -> int {
+        int err;
+        block.inFlight = false;
+
+        if ((err = clWaitForEvents(1, (cl_event *)&block.doneBarrier)))
+        {
+            vlog_error("Error:  Failed to wait for barrier:  %d\n", err);
+            gFailCount++;
+            return err;
+        }
+
+        if ((err = clReleaseEvent(block.calcReferenceValues)))
+        {
+            vlog_error("Error:  Failed to release calcReferenceValues:  %d\n",
+                       err);
+            gFailCount++;
+            return err;
+        }
+
+        if ((err = clReleaseEvent(block.doneBarrier)))
+        {
+            vlog_error("Error:  Failed to release done barrier:  %d\n", err);
+            gFailCount++;
+            return err;
+        }
+
+        for (int vs = gMinVectorSize; vs < gMaxVectorSize; vs++)
+        {
+            if ((err = block.calcInfo[vs]->result))
+            {
+                switch (inType)
+                {
+                    case kuchar:
+                    case kchar:
+                        vlog("Input value: 0x%2.2x ",
+                             ((unsigned char *)block.in)[err - 1]);
+                        break;
+                    case kushort:
+                    case kshort:
+                        vlog("Input value: 0x%4.4x ",
+                             ((unsigned short *)block.in)[err - 1]);
+                        break;
+                    case kuint:
+                    case kint:
+                        vlog("Input value: 0x%8.8x ",
+                             ((unsigned int *)block.in)[err - 1]);
+                        break;
+                    case khalf:
+                        vlog("Input value: %a ",
+                             HTF(((cl_half *)block.in)[err - 1]));
+                        break;
+                    case kfloat:
+                        vlog("Input value: %a ", ((float *)block.in)[err - 1]);
+                        break;
+                    case kulong:
+                    case klong:
+                        vlog("Input value: 0x%16.16llx ",
+                             ((unsigned long long *)block.in)[err - 1]);
+                        break;
+                    case kdouble:
+                        vlog("Input value: %a ", ((double *)block.in)[err - 1]);
+                        break;
+                    default:
+                        vlog_error("Internal error at %s: %d\n", __FILE__,
+                                   __LINE__);
+                        abort();
+                        break;
+                }
+
+                // tell the user which conversion it was.
+                if (0 == vs)
+                    vlog(" (implicit scalar conversion from %s to %s)\n",
+                         gTypeNames[inType], gTypeNames[outType]);
+                else
+                    vlog(" (convert_%s%s%s%s( %s%s ))\n", gTypeNames[outType],
+                         sizeNames[vs], gSaturationNames[sat],
+                         gRoundingModeNames[round], gTypeNames[inType],
+                         sizeNames[vs]);
+
+                gFailCount++;
+                return err;
+            }
+        }
+        return 0;
+    };
+
+    // On failure, let the blocks still in flight finish before their buffers
+    // and bookkeeping go away.
+    auto drainBlocks = [&]() {
+        clFinish(gQueue);
+        for (auto &block : blocks)
+            if (block.inFlight)
+            {
+                block.inFlight = false;
+                clWaitForEvents(1, (cl_event *)&block.doneBarrier);
+                clReleaseEvent(block.calcReferenceValues);
+                clReleaseEvent(block.doneBarrier);
+            }
+    };
+
     // Figure out how many elements are in a work block
     // we handle 64-bit types a bit differently.
     uint64_t lastCase = (8 * gTypeSizes[inType] > 32)
         ? 0x100000000ULL
         : 1ULL << (8 * gTypeSizes[inType]);
 
-    if (!gWimpyMode && gIsEmbedded)
+    if (!gWimpyMode && gIsEmbedded && !gExhaustive)
         step = blockCount * EMBEDDED_REDUCTION_FACTOR;
 
     if (gWimpyMode) step = (size_t)blockCount * (size_t)gWimpyReductionFactor;
     vlog("Testing... ");
     fflush(stdout);
+    size_t blockIndex = 0;
     for (i = 0; i < (uint64_t)lastCase; i += step)
     {
 
@@ -719,17 +854,30 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
             fflush(stdout);
         }
 
+        // Blocks are dealt out round robin to the shards
+        if ((i / step) % gShardCount != (uint64_t)gShardIndex) continue;
+
+        WriteInputBufferInfo &block = blocks[blockIndex++ % blocks.size()];
+
+        // The block's buffers are reused, so its previous contents must have
+        // been verified first.
+        if (block.inFlight && (error = retireBlock(block)))
+        {
+            drainBlocks();
+            return error;
+        }
+
         cl_uint count = (uint32_t)std::min((uint64_t)blockCount, lastCase - i);
-        writeInputBufferInfo.count = count;
+        block.count = count;
 
         // Crate a user event to represent the status of the reference value
         // computation completion
-        writeInputBufferInfo.calcReferenceValues =
-            clCreateUserEvent(gContext, &error);
-        if (error || NULL == writeInputBufferInfo.calcReferenceValues)
+        block.calcReferenceValues = clCreateUserEvent(gContext, &error);
+        if (error || NULL == block.calcReferenceValues)
         {
             vlog_error("ERROR: Unable to create user event. (%d)\n", error);
             gFailCount++;
+            drainBlocks();
             return error;
         }
 
@@ -737,32 +885,34 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
         for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
              vectorSize++)
         {
-            if ((error =
-                     clRetainEvent(writeInputBufferInfo.calcReferenceValues)))
+            if ((error = clRetainEvent(block.calcReferenceValues)))
             {
                 vlog_error("ERROR: Unable to retain user event. (%d)\n", error);
                 gFailCount++;
+                drainBlocks();
                 return error;
             }
         }
 
         // Crate a user event to represent when the callbacks are done verifying
         // correctness
-        writeInputBufferInfo.doneBarrier = clCreateUserEvent(gContext, &error);
-        if (error || NULL == writeInputBufferInfo.doneBarrier)
+        block.doneBarrier = clCreateUserEvent(gContext, &error);
+        if (error || NULL == block.doneBarrier)
         {
             vlog_error("ERROR: Unable to create user event for barrier. (%d)\n",
                        error);
             gFailCount++;
+            drainBlocks();
             return error;
         }
 
         // retain for use by the callback that calls this
-        if ((error = clRetainEvent(writeInputBufferInfo.doneBarrier)))
+        if ((error = clRetainEvent(block.doneBarrier)))
         {
             vlog_error("ERROR: Unable to retain user event doneBarrier. (%d)\n",
                        error);
             gFailCount++;
+            drainBlocks();
             return error;
         }
 
@@ -770,6 +920,9 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
         cl_uint chunks = RoundUpToNextPowerOfTwo(threads) * 2;
         init_info.start = i;
         init_info.size = count / chunks;
+        init_info.in = block.in;
+        init_info.ref = block.ref;
+        init_info.allowZ = block.allowZ;
         if (init_info.size < 16384)
         {
             chunks = RoundUpToNextPowerOfTwo(threads);
@@ -783,123 +936,56 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
 
         ThreadPool_Do(conv_test::InitData, chunks, &init_info);
 
-        // Copy the results to the device
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_TRUE, 0,
-                                          count * gTypeSizes[inType], gIn, 0,
-                                          NULL, NULL)))
+        // Copy the inputs to the device. The host copy is not touched again
+        // until the block is retired, so the write need not block.
+        if ((error = clEnqueueWriteBuffer(gQueue, block.inBuffer, CL_FALSE, 0,
+                                          count * gTypeSizes[inType], block.in,
+                                          0, NULL, NULL)))
         {
             vlog_error("ERROR: clEnqueueWriteBuffer failed. (%d)\n", error);
             gFailCount++;
+            drainBlocks();
             return error;
         }
 
         // Call completion callback for the write, which will enqueue the rest
         // of the work.
-        conv_test::WriteInputBufferComplete((void *)&writeInputBufferInfo);
+        conv_test::WriteInputBufferComplete((void *)&block);
 
         // Make sure the work is actually running, so we don't deadlock
         if ((error = clFlush(gQueue)))
         {
             vlog_error("clFlush failed with error %d\n", error);
             gFailCount++;
+            drainBlocks();
             return error;
         }
 
         ThreadPool_Do(conv_test::PrepareReference, chunks, &init_info);
 
         // signal we are done calculating the reference results
-        if ((error = clSetUserEventStatus(
-                 writeInputBufferInfo.calcReferenceValues, CL_COMPLETE)))
+        if ((error = clSetUserEventStatus(block.calcReferenceValues,
+                                          CL_COMPLETE)))
         {
             vlog_error(
                 "Error:  Failed to set user event status to CL_COMPLETE:  %d\n",
                 error);
             gFailCount++;
+            drainBlocks();
             return error;
         }
+        block.inFlight = true;
+    }
 
-        // Wait for the event callbacks to finish verifying correctness.
-        if ((error = clWaitForEvents(
-                 1, (cl_event *)&writeInputBufferInfo.doneBarrier)))
-        {
-            vlog_error("Error:  Failed to wait for barrier:  %d\n", error);
-            gFailCount++;
-            return error;
-        }
-
-        if ((error = clReleaseEvent(writeInputBufferInfo.calcReferenceValues)))
-        {
-            vlog_error("Error:  Failed to release calcReferenceValues:  %d\n",
-                       error);
-            gFailCount++;
-            return error;
-        }
-
-        if ((error = clReleaseEvent(writeInputBufferInfo.doneBarrier)))
+    // Verify whatever is still in flight, oldest block first.
+    for (size_t b = 0; b < blocks.size(); b++)
+    {
+        WriteInputBufferInfo &block = blocks[(blockIndex + b) % blocks.size()];
+        if (block.inFlight && (error = retireBlock(block)))
         {
-            vlog_error("Error:  Failed to release done barrier:  %d\n", error);
-            gFailCount++;
+            drainBlocks();
             return error;
         }
-
-        for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
-             vectorSize++)
-        {
-            if ((error = writeInputBufferInfo.calcInfo[vectorSize]->result))
-            {
-                switch (inType)
-                {
-                    case kuchar:
-                    case kchar:
-                        vlog("Input value: 0x%2.2x ",
-                             ((unsigned char *)gIn)[error - 1]);
-                        break;
-                    case kushort:
-                    case kshort:
-                        vlog("Input value: 0x%4.4x ",
-                             ((unsigned short *)gIn)[error - 1]);
-                        break;
-                    case kuint:
-                    case kint:
-                        vlog("Input value: 0x%8.8x ",
-                             ((unsigned int *)gIn)[error - 1]);
-                        break;
-                    case khalf:
-                        vlog("Input value: %a ",
-                             HTF(((cl_half *)gIn)[error - 1]));
-                        break;
-                    case kfloat:
-                        vlog("Input value: %a ", ((float *)gIn)[error - 1]);
-                        break;
-                    case kulong:
-                    case klong:
-                        vlog("Input value: 0x%16.16llx ",
-                             ((unsigned long long *)gIn)[error - 1]);
-                        break;
-                    case kdouble:
-                        vlog("Input value: %a ", ((double *)gIn)[error - 1]);
-                        break;
-                    default:
-                        vlog_error("Internal error at %s: %d\n", __FILE__,
-                                   __LINE__);
-                        abort();
-                        break;
-                }
-
-                // tell the user which conversion it was.
-                if (0 == vectorSize)
-                    vlog(" (implicit scalar conversion from %s to %s)\n",
-                         gTypeNames[inType], gTypeNames[outType]);
-                else
-                    vlog(" (convert_%s%s%s%s( %s%s ))\n", gTypeNames[outType],
-                         sizeNames[vectorSize], gSaturationNames[sat],
-                         gRoundingModeNames[round], gTypeNames[inType],
-                         sizeNames[vectorSize]);
-
-                gFailCount++;
-                return error;
-            }
-        }
     }
 
     log_info("done.\n");
@@ -922,8 +1008,9 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
             {
                 uint64_t startTime = conv_test::GetTime();
                 if ((error = conv_test::RunKernel(
-                         writeInputBufferInfo.calcInfo[vectorSize]->kernel,
-                         gInBuffer, gOutBuffers[vectorSize], workItemCount)))
+                         blocks[0].calcInfo[vectorSize]->kernel,
+                         gInBuffers[0], gOutBuffers[0][vectorSize],
+                         workItemCount)))
                 {
                     gFailCount++;
                     return error;
@@ -1045,6 +1132,24 @@ void MapResultValuesComplete(const std::unique_ptr<CalcRefValsBase> &info)
     // destroyed automatically soon after we exit.
 }
 
+// Called once the results of one vector size have been mapped back from the
+// device. The map is non-blocking so the main thread can move on to the next
+// block while this one is in flight.
+static void CL_CALLBACK MapResultValuesReady(cl_event e, cl_int status,
+                                             void *data)
+{
+    std::unique_ptr<CalcRefValsBase> &info =
+        *(std::unique_ptr<CalcRefValsBase> *)data;
+
+    if (CL_SUCCESS != status)
+    {
+        vlog_error("ERROR: mapping results did not succeed! (%d)\n", status);
+        gFailCount++; // lazy about thread safety here
+    }
+
+    MapResultValuesComplete(info);
+}
+
 template <typename T> static bool isnan_fp(const T &v)
 {
     if (std::is_same<T, cl_half>::value)
@@ -1109,44 +1214,44 @@ void FixNanConversions(Type outType, Type inType, void *d, cl_uint count,
         // float/double/half could be any NaN
         if (inType == kfloat)
         {
-            float *inp = (float *)gIn;
+            float *in = (float *)inp;
             if (outType == kdouble)
             {
                 double *outp = (double *)d;
-                FixNanToFltConversions(inp, outp, count);
+                FixNanToFltConversions(in, outp, count);
             }
             else if (outType == khalf)
             {
                 cl_half *outp = (cl_half *)d;
-                FixNanToFltConversions(inp, outp, count);
+                FixNanToFltConversions(in, outp, count);
             }
         }
         else if (inType == kdouble)
         {
-            double *inp = (double *)gIn;
+            double *in = (double *)inp;
             if (outType == kfloat)
             {
                 float *outp = (float *)d;
-                FixNanToFltConversions(inp, outp, count);
+                FixNanToFltConversions(in, outp, count);
             }
             else if (outType == khalf)
             {
                 cl_half *outp = (cl_half *)d;
-                FixNanToFltConversions(inp, outp, count);
+                FixNanToFltConversions(in, outp, count);
             }
         }
         else if (inType == khalf)
         {
-            cl_half *inp = (cl_half *)gIn;
+            cl_half *in = (cl_half *)inp;
             if (outType == kfloat)
             {
                 float *outp = (float *)d;
-                FixNanToFltConversions(inp, outp, count);
+                FixNanToFltConversions(in, outp, count);
             }
             else if (outType == kdouble)
             {
                 double *outp = (double *)d;
-                FixNanToFltConversions(inp, outp, count);
+                FixNanToFltConversions(in, outp, count);
             }
         }
     }
@@ -1185,9 +1290,9 @@ void CL_CALLBACK CalcReferenceValuesComplete(cl_event e, cl_int status,
 
     // Patch up NaNs conversions to integer to zero -- these can be converted to
     // any integer
-    FixNanConversions(outType, inType, mapped, count, gIn);
+    FixNanConversions(outType, inType, mapped, count, info->parent->in);
 
-    if (memcmp(mapped, gRef, count * gTypeSizes[outType]))
+    if (memcmp(mapped, info->parent->ref, count * gTypeSizes[outType]))
         info->result =
             info->check_result(mapped, count, vectorSizes[vectorSize]);
     else
@@ -1197,8 +1302,9 @@ void CL_CALLBACK CalcReferenceValuesComplete(cl_event e, cl_int status,
     {
         cl_uint pattern = 0xffffdead;
         memset_pattern4(mapped, &pattern, count * gTypeSizes[outType]);
-        if ((error = clEnqueueUnmapMemObject(gQueue, gOutBuffers[vectorSize],
-                                             mapped, 0, NULL, NULL)))
+        if ((error = clEnqueueUnmapMemObject(
+                 gQueue, info->parent->outBuffers[vectorSize], mapped, 0, NULL,
+                 NULL)))
         {
             vlog_error("ERROR: clEnqueueUnmapMemObject failed in "
                        "CalcReferenceValuesComplete  (%d)\n",
@@ -1233,8 +1339,157 @@ void CL_CALLBACK CalcReferenceValuesComplete(cl_event e, cl_int status,
     // CalcReferenceValuesComplete exit.
 }
 
+size_t ConvertHalfToFloatRef(cl_float *out, const cl_half *in, size_t n)
+{
+    // Every half value decoded once. Lookups move the bits unchanged, so NaN
+    // payloads and denormals survive just as with HTF.
+    static const std::vector<cl_float> table = [] {
+        std::vector<cl_float> t(1 << 16);
+        for (size_t i = 0; i < t.size(); i++) t[i] = HTF((cl_half)i);
+        return t;
+    }();
+
+    for (size_t i = 0; i < n; i++) out[i] = table[in[i]];
+    return n;
+}
+
+#if defined(__SSE2__) || defined(_MSC_VER)
+// Round four floats to int in the current rounding mode. NaN and out of range
+// lanes give 0x80000000 as the scalar cast does, unless sat is set, in which
+// case positive overflow gives 0x7fffffff.
+static inline __m128i RoundFloatToInt(__m128 v, bool sat)
+{
+    __m128i r = _mm_cvtps_epi32(v);
+    if (sat)
+    {
+        // flipping all bits of 0x80000000 gives 0x7fffffff
+        __m128 over = _mm_cmpge_ps(v, _mm_set1_ps(2147483648.0f));
+        r = _mm_xor_si128(r, _mm_castps_si128(over));
+    }
+    return r;
+}
+
+// Load four int or float values as saturated int
+static inline __m128i LoadIntSat(const void *in, Type inType, size_t i)
+{
+    if (inType == kfloat)
+        return RoundFloatToInt(_mm_loadu_ps((const float *)in + i), true);
+    return _mm_loadu_si128((const __m128i *)((const cl_int *)in + i));
+}
+#endif
+
+size_t ConvertIntToFloatRef(cl_float *out, const cl_int *in, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__) || defined(_MSC_VER)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        _mm_storeu_ps(out + i, _mm_cvtepi32_ps(v));
+    }
+#endif
+    return i;
+}
+
+size_t ConvertUIntToFloatRef(cl_float *out, const cl_uint *in, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__) || defined(_MSC_VER)
+    const __m128i low31 = _mm_set1_epi32(0x7fffffff);
+    const __m128d two31 = _mm_set1_pd(2147483648.0);
+    for (; i + 4 <= n; i += 4)
+    {
+        // Split off the top bit so both halves convert as signed ints. The
+        // sum is exact in double (and +0.0 for 0 in every rounding mode), so
+        // the only rounding is the final one to float.
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i lo = _mm_and_si128(v, low31);
+        __m128i hi = _mm_srli_epi32(v, 31);
+        __m128d d0 = _mm_add_pd(_mm_cvtepi32_pd(lo),
+                                _mm_mul_pd(_mm_cvtepi32_pd(hi), two31));
+        lo = _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2));
+        hi = _mm_shuffle_epi32(hi, _MM_SHUFFLE(1, 0, 3, 2));
+        __m128d d1 = _mm_add_pd(_mm_cvtepi32_pd(lo),
+                                _mm_mul_pd(_mm_cvtepi32_pd(hi), two31));
+        _mm_storeu_ps(out + i,
+                      _mm_movelh_ps(_mm_cvtpd_ps(d0), _mm_cvtpd_ps(d1)));
+    }
+#endif
+    return i;
+}
+
+size_t ConvertFloatToIntRef(cl_int *out, const cl_float *in, size_t n,
+                            bool sat)
+{
+    size_t i = 0;
+#if defined(__SSE2__) || defined(_MSC_VER)
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i *)(out + i),
+                         RoundFloatToInt(_mm_loadu_ps(in + i), sat));
+#endif
+    return i;
+}
+
+size_t ConvertNarrowSatRef(void *out, Type outType, const void *in,
+                           Type inType, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__) || defined(_MSC_VER)
+    if (inType != kint && inType != kfloat && inType != kshort) return 0;
+
+    if (outType == kshort && inType != kshort)
+    {
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i r = _mm_packs_epi32(LoadIntSat(in, inType, i),
+                                        LoadIntSat(in, inType, i + 4));
+            _mm_storeu_si128((__m128i *)((cl_short *)out + i), r);
+        }
+    }
+    else if (outType == kchar || outType == kuchar)
+    {
+        for (; i + 16 <= n; i += 16)
+        {
+            // Saturate to short first, then to the byte type. Clamping to the
+            // wider range first does not change the final result.
+            __m128i lo, hi;
+            if (inType == kshort)
+            {
+                lo = _mm_loadu_si128(
+                    (const __m128i *)((const cl_short *)in + i));
+                hi = _mm_loadu_si128(
+                    (const __m128i *)((const cl_short *)in + i + 8));
+            }
+            else
+            {
+                lo = _mm_packs_epi32(LoadIntSat(in, inType, i),
+                                     LoadIntSat(in, inType, i + 4));
+                hi = _mm_packs_epi32(LoadIntSat(in, inType, i + 8),
+                                     LoadIntSat(in, inType, i + 12));
+            }
+            __m128i r = outType == kchar ? _mm_packs_epi16(lo, hi)
+                                         : _mm_packus_epi16(lo, hi);
+            _mm_storeu_si128((__m128i *)((cl_uchar *)out + i), r);
+        }
+    }
+#endif
+    return i;
+}
+
 namespace conv_test {
 
+void ReportShardResult(Type outType, Type inType, SaturationMode sat,
+                       RoundingMode round, int error)
+{
+    // One line per conversion so that run_exhaustive.py can merge the
+    // results of all the shards
+    if (gExhaustive)
+        vlog("SHARD %d/%d convert_%sn%s%s( %sn ) %s\n", gShardIndex,
+             gShardCount, gTypeNames[outType], gSaturationNames[sat],
+             gRoundingModeNames[round], gTypeNames[inType],
+             error ? "FAIL" : "PASS");
+}
+
 cl_int InitData(cl_uint job_id, cl_uint thread_id, void *p)
 {
     DataInitBase *info = (DataInitBase *)p;
@@ -1255,9 +1510,10 @@ cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p)
 
     Force64BitFPUPrecision();
 
-    void *s = (cl_uchar *)gIn + job_id * count * gTypeSizes[info->inType];
-    void *a = (cl_uchar *)gAllowZ + job_id * count;
-    void *d = (cl_uchar *)gRef + job_id * count * gTypeSizes[info->outType];
+    void *s = (cl_uchar *)info->in + job_id * count * gTypeSizes[info->inType];
+    void *a = (cl_uchar *)info->allowZ + job_id * count;
+    void *d =
+        (cl_uchar *)info->ref + job_id * count * gTypeSizes[info->outType];
 
     if (outType != inType)
     {
@@ -1383,35 +1639,34 @@ void WriteInputBufferComplete(void *data)
         size_t workItemCount =
             (count + vectorSizes[vectorSize] - 1) / (vectorSizes[vectorSize]);
 
-        if ((status = conv_test::RunKernel(info->calcInfo[vectorSize]->kernel,
-                                           gInBuffer, gOutBuffers[vectorSize],
-                                           workItemCount)))
+        if ((status = conv_test::RunKernel(
+                 info->calcInfo[vectorSize]->kernel, info->inBuffer,
+                 info->outBuffers[vectorSize], workItemCount)))
         {
             gFailCount++;
             return;
         }
 
+        cl_event mapEvent = NULL;
         info->calcInfo[vectorSize]->p = clEnqueueMapBuffer(
-            gQueue, gOutBuffers[vectorSize], CL_TRUE,
+            gQueue, info->outBuffers[vectorSize], CL_FALSE,
             CL_MAP_READ | CL_MAP_WRITE, 0, count * gTypeSizes[info->outType], 0,
-            NULL, NULL, &status);
+            NULL, &mapEvent, &status);
+        if (status == CL_SUCCESS)
+            status = clSetEventCallback(mapEvent, CL_COMPLETE,
+                                        MapResultValuesReady,
+                                        (void *)&info->calcInfo[vectorSize]);
+        if (mapEvent) clReleaseEvent(mapEvent);
+        if (status)
         {
-            if (status)
-            {
-                vlog_error("ERROR: WriteInputBufferComplete calback failed "
-                           "with status: %d\n",
-                           status);
-                gFailCount++;
-                return;
-            }
+            vlog_error("ERROR: WriteInputBufferComplete calback failed "
+                       "with status: %d\n",
+                       status);
+            gFailCount++;
+            return;
         }
     }
 
-    for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
-    {
-        MapResultValuesComplete(info->calcInfo[vectorSize]);
-    }
-
     // Make sure the work starts moving -- otherwise we may deadlock
     if ((status = clFlush(gQueue)))
     {
@@ -1426,19 +1681,15 @@ void WriteInputBufferComplete(void *data)
     // automatically soon after we exit.
 }
 
-cl_program MakeProgram(Type outType, Type inType, SaturationMode sat,
-                       RoundingMode round, int vectorSize, cl_kernel *outKernel)
+// Source of the kernel testing one conversion, its name is returned in
+// kernelName.
+static std::string ConversionKernelSource(Type outType, Type inType,
+                                          SaturationMode sat,
+                                          RoundingMode round, int vectorSize,
+                                          std::string &kernelName, bool verbose)
 {
-    cl_program program;
     char testName[256];
-    int error = 0;
-
     std::ostringstream source;
-    if (outType == kdouble || inType == kdouble)
-        source << "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n";
-
-    if (outType == khalf || inType == khalf)
-        source << "#pragma OPENCL EXTENSION cl_khr_fp16 : enable\n";
 
     // Create the program. This is a bit complicated because we are trying to
     // avoid byte and short stores.
@@ -1460,9 +1711,9 @@ cl_program MakeProgram(Type outType, Type inType, SaturationMode sat,
         source << "   dest[i] =  src[i];\n";
         source << "}\n";
 
-        vlog("Building implicit %s -> %s conversion test\n", gTypeNames[inType],
-             gTypeNames[outType]);
-        fflush(stdout);
+        if (verbose)
+            vlog("Building implicit %s -> %s conversion test\n",
+                 gTypeNames[inType], gTypeNames[outType]);
     }
     else
     {
@@ -1483,7 +1734,8 @@ cl_program MakeProgram(Type outType, Type inType, SaturationMode sat,
                          outName, gSaturationNames[sat],
                          gRoundingModeNames[round]);
                 snprintf(testName, 256, "test_%s_%s", convertString, inName);
-                vlog("Building %s( %s ) test\n", convertString, inName);
+                if (verbose)
+                    vlog("Building %s( %s ) test\n", convertString, inName);
                 break;
             case 3:
                 strncpy(inName, gTypeNames[inType], sizeof(inName) - 1);
@@ -1494,7 +1746,8 @@ cl_program MakeProgram(Type outType, Type inType, SaturationMode sat,
                          "convert_%s3%s%s", outName, gSaturationNames[sat],
                          gRoundingModeNames[round]);
                 snprintf(testName, 256, "test_%s_%s3", convertString, inName);
-                vlog("Building %s( %s3 ) test\n", convertString, inName);
+                if (verbose)
+                    vlog("Building %s( %s3 ) test\n", convertString, inName);
                 break;
             default:
                 snprintf(inName, sizeof(inName), "%s%d", gTypeNames[inType],
@@ -1505,10 +1758,10 @@ cl_program MakeProgram(Type outType, Type inType, SaturationMode sat,
                          outName, gSaturationNames[sat],
                          gRoundingModeNames[round]);
                 snprintf(testName, 256, "test_%s_%s", convertString, inName);
-                vlog("Building %s( %s ) test\n", convertString, inName);
+                if (verbose)
+                    vlog("Building %s( %s ) test\n", convertString, inName);
                 break;
         }
-        fflush(stdout);
 
         if (vectorSizetmp == 3)
         {
@@ -1543,20 +1796,144 @@ cl_program MakeProgram(Type outType, Type inType, SaturationMode sat,
             source << "}\n";
         }
     }
-    *outKernel = NULL;
+    fflush(stdout);
 
-    const char *flags = NULL;
+    kernelName = testName;
+    return source.str();
+}
+
+static std::string ConversionProgramHeader(Type outType, Type inType)
+{
+    std::string header;
+    if (outType == kdouble || inType == kdouble)
+        header += "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n";
+
+    if (outType == khalf || inType == khalf)
+        header += "#pragma OPENCL EXTENSION cl_khr_fp16 : enable\n";
+
+    return header;
+}
+
+static const char *ConversionBuildFlags(Type outType, Type inType)
+{
     if ((gForceFTZ && (inType == kfloat || outType == kfloat))
         || (gForceHalfFTZ && (inType == khalf || outType == khalf)))
     {
-        flags = "-cl-denorms-are-zero";
+        return "-cl-denorms-are-zero";
+    }
+    return NULL;
+}
+
+// With -b, one program holds the kernels of every tested vector size and
+// saturation/rounding variant of a type pair and is built once for all of that
+// pair's tests. Tests run pair by pair, so only the last pair is kept.
+static cl_program batchProgram = NULL;
+static Type batchOutType, batchInType;
+
+void ReleaseBatchedProgram(void)
+{
+    if (batchProgram) clReleaseProgram(batchProgram);
+    batchProgram = NULL;
+}
+
+static cl_program MakeBatchedProgram(Type outType, Type inType,
+                                     SaturationMode sat, RoundingMode round,
+                                     int vectorSize, cl_kernel *outKernel)
+{
+    std::string kernelName;
+    int error = 0;
+
+    if (NULL == batchProgram || batchOutType != outType
+        || batchInType != inType)
+    {
+        ReleaseBatchedProgram();
+
+        // The program is reused by every call for this pair, including the
+        // calls that test the implicit conversions. gMinVectorSize is only
+        // raised to 1 to skip those for the current call, so build them too.
+        int firstVectorSize = (gMinVectorSize == 1) ? 0 : gMinVectorSize;
+
+        std::string source = ConversionProgramHeader(outType, inType);
+        std::string firstKernel;
+        for (int s = 0; s < kSaturationModeCount; s++)
+        {
+            // saturated conversions to floating point types are illegal
+            if (kSaturated == s
+                && (outType == kfloat || outType == kdouble
+                    || outType == khalf))
+                continue;
+
+            for (int r = 0; r < kRoundingModeCount; r++)
+            {
+                for (int v = firstVectorSize; v < gMaxVectorSize; v++)
+                {
+                    // implicit conversions only exist in the default mode
+                    if (0 == v && (s || r != kDefaultRoundingMode)) continue;
+
+                    source += ConversionKernelSource(
+                        outType, inType, (SaturationMode)s, (RoundingMode)r, v,
+                        kernelName, false);
+                    if (firstKernel.empty()) firstKernel = kernelName;
+                }
+            }
+        }
+
+        vlog("Building all %s -> %s conversion tests\n", gTypeNames[inType],
+             gTypeNames[outType]);
+        fflush(stdout);
+
+        const char *programSource = source.c_str();
+        clKernelWrapper kernel;
+        error = create_single_kernel_helper(
+            gContext, &batchProgram, &kernel, 1, &programSource,
+            firstKernel.c_str(), ConversionBuildFlags(outType, inType));
+        if (error)
+        {
+            vlog_error("Failed to build kernel/program (err = %d).\n", error);
+            ReleaseBatchedProgram();
+            return NULL;
+        }
+        batchOutType = outType;
+        batchInType = inType;
+    }
+
+    ConversionKernelSource(outType, inType, sat, round, vectorSize, kernelName,
+                           false);
+    *outKernel = clCreateKernel(batchProgram, kernelName.c_str(), &error);
+    if (error)
+    {
+        vlog_error("Failed to create kernel %s (err = %d).\n",
+                   kernelName.c_str(), error);
+        *outKernel = NULL;
+        return NULL;
     }
 
+    // the caller owns a reference of its own
+    clRetainProgram(batchProgram);
+    return batchProgram;
+}
+
+cl_program MakeProgram(Type outType, Type inType, SaturationMode sat,
+                       RoundingMode round, int vectorSize, cl_kernel *outKernel)
+{
+    if (gBatchPrograms)
+        return MakeBatchedProgram(outType, inType, sat, round, vectorSize,
+                                  outKernel);
+
+    cl_program program;
+    std::string testName;
+    int error = 0;
+
+    std::string source = ConversionProgramHeader(outType, inType)
+        + ConversionKernelSource(outType, inType, sat, round, vectorSize,
+                                 testName, true);
+    *outKernel = NULL;
+
     // build it
-    std::string sourceString = source.str();
-    const char *programSource = sourceString.c_str();
+    const char *programSource = source.c_str();
     error = create_single_kernel_helper(gContext, &program, outKernel, 1,
-                                        &programSource, testName, flags);
+                                        &programSource, testName.c_str(),
+                                        ConversionBuildFlags(outType, inType));
     if (error)
     {
         vlog_error("Failed to build kernel/program (err = %d).\n", error);
@@ -47,6 +47,9 @@
 #define kPageSize 4096
 
 #define BUFFER_SIZE (1024 * 1024)
+// Number of blocks kept in flight, so that input generation, device
+// conversion and verification of different blocks overlap
+#define kPipelineDepth 4
 #define EMBEDDED_REDUCTION_FACTOR 16
 #define PERF_LOOP_COUNT 100
 
@@ -74,8 +77,9 @@ extern CheckResults gCheckResults[ kTypeCount ];
 extern MTdata gMTdata;
 extern cl_command_queue gQueue;
 extern cl_context gContext;
-extern cl_mem gInBuffer;
-extern cl_mem gOutBuffers[];
+extern cl_mem gInBuffers[kPipelineDepth];
+extern cl_mem gOutBuffers[kPipelineDepth][kCallStyleCount];
+extern int gPipelineDepth;
 extern int gHasDouble;
 extern int gTestDouble;
 extern int gHasHalfs;
@@ -83,6 +87,9 @@ extern int gTestHalfs;
 extern int gWimpyMode;
 extern int gWimpyReductionFactor;
 extern int gSkipTesting;
+extern int gBatchPrograms;
+extern int gShardIndex;
+extern int gShardCount;
 extern int gMinVectorSize;
 extern int gMaxVectorSize;
 extern int gForceFTZ;
@@ -93,9 +100,9 @@ extern int gEndTestNumber;
 extern int gIsRTZ;
 extern int gForceHalfFTZ;
 extern int gIsHalfRTZ;
-extern void *gIn;
-extern void *gRef;
-extern void *gAllowZ;
+extern void *gIn[kPipelineDepth];
+extern void *gRef[kPipelineDepth];
+extern void *gAllowZ[kPipelineDepth];
 extern void *gOut[];
 
 extern const char **argList;
@@ -123,6 +130,9 @@ cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p);
 uint64_t GetTime(void);
 
 void WriteInputBufferComplete(void *);
+void ReleaseBatchedProgram(void);
+void ReportShardResult(Type outType, Type inType, SaturationMode sat,
+                       RoundingMode round, int error);
 void *FlushToZero(void);
 void UnFlushToZero(void *);
 }
@@ -151,7 +161,9 @@ struct WriteInputBufferInfo
 {
     WriteInputBufferInfo()
         : calcReferenceValues(nullptr), doneBarrier(nullptr), count(0),
-          outType(kuchar), inType(kuchar), barrierCount(0)
+          outType(kuchar), inType(kuchar), barrierCount(0), in(nullptr),
+          ref(nullptr), allowZ(nullptr), inBuffer(nullptr),
+          outBuffers(nullptr), inFlight(false)
     {}
 
     volatile cl_event
@@ -164,6 +176,13 @@ struct WriteInputBufferInfo
     Type inType; // the data type of the conversion input
     volatile int barrierCount;
 
+    void *in; // the input values of this block
+    void *ref; // the reference results of this block
+    void *allowZ; // whether a zero result is allowed, per element
+    cl_mem inBuffer; // the device copy of the input values
+    cl_mem *outBuffers; // the device results, per vector size
+    bool inFlight; // set while the block's results are still being verified
+
     std::vector<std::unique_ptr<CalcRefValsBase>> calcInfo;
 };
 
@@ -358,8 +377,11 @@ protected:
         {
             // run selected conversion
             // testing of the result will happen afterwards
-            test.DoTest<InType, OutType, isTypeFp[In], isTypeFp[Out]>(
-                outType, inType, saturation, rounding);
+            int error =
+                test.DoTest<InType, OutType, isTypeFp[In], isTypeFp[Out]>(
+                    outType, inType, saturation, rounding);
+            conv_test::ReportShardResult(outType, inType, saturation,
+                                         rounding, error);
         }
     }
 
@@ -35,6 +35,7 @@ extern roundingMode qcom_rm;
 #include "harness/rounding_mode.h"
 #include "harness/typeWrappers.h"
 
+#include <atomic>
 #include <vector>
 
 #if defined(__linux__)
@@ -43,7 +44,24 @@ extern roundingMode qcom_rm;
 #endif
 
 extern size_t gTypeSizes[kTypeCount];
-extern void *gIn;
+extern const char *gTypeNames[kTypeCount];
+// Cleared by the worker threads when a vectorized reference disagrees with
+// the scalar one
+extern std::atomic<int> gSimdReference;
+extern int gExhaustive;
+
+// Vectorized reference conversions, defined in basic_test_conversions.cpp.
+// Each converts a leading run of the n elements of in, bit-identical to
+// DataInfoSpec::conv / conv_sat under the current rounding mode, and returns
+// how many elements it converted. The scalar path converts the rest.
+size_t ConvertHalfToFloatRef(cl_float *out, const cl_half *in, size_t n);
+size_t ConvertIntToFloatRef(cl_float *out, const cl_int *in, size_t n);
+size_t ConvertUIntToFloatRef(cl_float *out, const cl_uint *in, size_t n);
+size_t ConvertFloatToIntRef(cl_int *out, const cl_float *in, size_t n,
+                            bool sat);
+// Saturating int/short/float -> short/char/uchar conversions
+size_t ConvertNarrowSatRef(void *out, Type outType, const void *in,
+                           Type inType, size_t n);
 
 
 typedef enum
@@ -64,6 +82,11 @@ struct DataInitInfo
     RoundingMode round;
     cl_uint threads;
 
+    // the buffers of the block being generated
+    void *in;
+    void *ref;
+    void *allowZ;
+
     static cl_half_rounding_mode halfRoundingMode;
     static std::vector<uint32_t> specialValuesUInt;
     static std::vector<float> specialValuesFloat;
@@ -124,15 +147,19 @@ struct DataInfoSpec : public DataInitBase
         return (std::is_same<OutType, cl_half>::value && OutFP);
     }
 
+    // vectorized conversion of a leading run of the array, returns the number
+    // of elements converted
+    size_t conv_array_simd(void *out, void *in, size_t n, bool sat);
+
     void conv_array(void *out, void *in, size_t n) override
     {
-        for (size_t i = 0; i < n; i++)
+        for (size_t i = conv_array_simd(out, in, n, false); i < n; i++)
             conv(&((OutType *)out)[i], &((InType *)in)[i]);
     }
 
     void conv_array_sat(void *out, void *in, size_t n) override
     {
-        for (size_t i = 0; i < n; i++)
+        for (size_t i = conv_array_simd(out, in, n, true); i < n; i++)
             conv_sat(&((OutType *)out)[i], &((InType *)in)[i]);
     }
 
@@ -730,6 +757,55 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::conv_sat(OutType *out,
     }
 }
 
+template <typename InType, typename OutType, bool InFP, bool OutFP>
+size_t DataInfoSpec<InType, OutType, InFP, OutFP>::conv_array_simd(void *out,
+                                                                   void *in,
+                                                                   size_t n,
+                                                                   bool sat)
+{
+    if (!gSimdReference) return 0;
+
+    size_t done = 0;
+    if (is_in_half() && std::is_same<cl_float, OutType>::value)
+        done = ConvertHalfToFloatRef((cl_float *)out, (const cl_half *)in, n);
+    else if (std::is_same<cl_int, InType>::value
+             && std::is_same<cl_float, OutType>::value)
+        done = ConvertIntToFloatRef((cl_float *)out, (const cl_int *)in, n);
+    else if (std::is_same<cl_uint, InType>::value
+             && std::is_same<cl_float, OutType>::value)
+        done = ConvertUIntToFloatRef((cl_float *)out, (const cl_uint *)in, n);
+    else if (std::is_same<cl_float, InType>::value
+             && std::is_same<cl_int, OutType>::value)
+        done =
+            ConvertFloatToIntRef((cl_int *)out, (const cl_float *)in, n, sat);
+    else if (sat && !is_out_half())
+        done = ConvertNarrowSatRef(out, outType, in, inType, n);
+
+    // The scalar conversion remains the oracle. Spot check every 4093rd and
+    // the last vectorized result against it, and fall back to it entirely on
+    // a mismatch.
+    for (size_t i = 0; i < done; i += std::min<size_t>(4093, done - i - 1) + 1)
+    {
+        OutType expected;
+        if (sat)
+            conv_sat(&expected, &((InType *)in)[i]);
+        else
+            conv(&expected, &((InType *)in)[i]);
+
+        if (memcmp(&expected, &((OutType *)out)[i], sizeof(OutType)))
+        {
+            vlog_error("ERROR: vectorized reference for %s -> %s%s differs "
+                       "from the scalar one at element %zu, disabling it.\n",
+                       gTypeNames[inType], gTypeNames[outType],
+                       sat ? "_sat" : "", i);
+            gSimdReference = 0;
+            return 0;
+        }
+    }
+
+    return done;
+}
+
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 void DataInfoSpec<InType, OutType, InFP, OutFP>::set_allow_zero(uint8_t *allow,
                                                                 OutType *out,
@@ -759,14 +835,21 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
                                                       const cl_uint &thread_id)
 {
     uint64_t ulStart = start;
-    void *pIn = (char *)gIn + job_id * size * gTypeSizes[inType];
+    void *pIn = (char *)in + job_id * size * gTypeSizes[inType];
+
+    // Random inputs are seeded from the position of the job in the input
+    // space, so a block draws the same samples whichever shard tests it and
+    // different blocks draw different ones.
+    uint64_t first = ulStart + (uint64_t)job_id * size;
+    mdv[thread_id] =
+        MTdataHolder(gRandomSeed ^ (cl_uint)first ^ (cl_uint)(first >> 32));
 
     if (is_in_half())
     {
         cl_half *o = (cl_half *)pIn;
         int i;
 
-        if (gIsEmbedded)
+        if (gIsEmbedded && !gExhaustive)
             for (i = 0; i < size; i++)
                 o[i] = (cl_half)genrand_int32(mdv[thread_id]);
         else
@@ -797,7 +880,7 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
         else if (sizeof(InType) <= sizeof(cl_int))
         { // int/uint
             int i = 0;
-            if (gIsEmbedded)
+            if (gIsEmbedded && !gExhaustive)
                 for (i = 0; i < size; i++)
                     o[i] = (InType)genrand_int32(mdv[thread_id]);
             else
@@ -881,7 +964,7 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
         cl_uint *o = (cl_uint *)pIn;
         int i;
 
-        if (gIsEmbedded)
+        if (gIsEmbedded && !gExhaustive)
             for (i = 0; i < size; i++)
                 o[i] = (cl_uint)genrand_int32(mdv[thread_id]);
         else
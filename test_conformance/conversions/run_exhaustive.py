@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 The Khronos Group Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Run test_conversions exhaustively, split into shards, and merge results.
+
+Each shard runs "<command> --exhaustive --shard i/N" and tests every N-th
+block of inputs of every conversion. A conversion passes only if every shard
+reports it as passing.
+
+Run all the shards on this machine, a few at a time:
+
+    run_exhaustive.py --shards 16 --jobs 4 -- ./test_conversions
+
+Or run the shards anywhere (e.g. one per machine of a pool), keep their
+output, and merge the logs afterwards:
+
+    run_exhaustive.py --merge shard_*.log
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+SHARD_LINE = re.compile(r"^SHARD (\d+)/(\d+) (.+) (PASS|FAIL)$")
+
+
+def run_shards(command, shards, jobs, log_dir):
+    os.makedirs(log_dir, exist_ok=True)
+    logs = []
+    running = []
+    for shard in range(shards):
+        log = os.path.join(log_dir, "shard_%d_of_%d.log" % (shard, shards))
+        logs.append(log)
+        with open(log, "w") as out:
+            args = command + ["--exhaustive", "--shard",
+                              "%d/%d" % (shard, shards)]
+            print("Starting: " + " ".join(args))
+            running.append(subprocess.Popen(args, stdout=out,
+                                            stderr=subprocess.STDOUT))
+        if len(running) >= jobs:
+            running.pop(0).wait()
+    for process in running:
+        process.wait()
+    return logs
+
+
+def merge(logs):
+    shard_count = None
+    results = {}  # conversion -> {shard: passed}
+    for log in logs:
+        with open(log, errors="replace") as f:
+            for line in f:
+                match = SHARD_LINE.match(line.strip())
+                if not match:
+                    continue
+                shard, count, name, status = match.groups()
+                if shard_count is None:
+                    shard_count = int(count)
+                elif shard_count != int(count):
+                    sys.exit("ERROR: %s mixes runs with different shard "
+                             "counts" % log)
+                shards = results.setdefault(name, {})
+                # a conversion that ever fails in a shard stays failed
+                shards[int(shard)] = (shards.get(int(shard), True)
+                                      and status == "PASS")
+
+    if shard_count is None:
+        sys.exit("ERROR: no shard results found, were the logs produced with "
+                 "--exhaustive?")
+
+    failed = []
+    incomplete = []
+    for name, shards in results.items():
+        if not all(shards.values()):
+            failed.append(name)
+        elif len(shards) != shard_count:
+            incomplete.append((name, sorted(set(range(shard_count))
+                                            - set(shards))))
+
+    print("%d conversions over %d shards: %d passed, %d failed, "
+          "%d incomplete" % (len(results), shard_count,
+                             len(results) - len(failed) - len(incomplete),
+                             len(failed), len(incomplete)))
+    for name in sorted(failed):
+        print("FAILED: " + name)
+    for name, missing in sorted(incomplete):
+        print("INCOMPLETE: %s (missing shards %s)"
+              % (name, ", ".join(str(s) for s in missing)))
+    return 1 if failed or incomplete else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--shards", type=int, default=os.cpu_count(),
+                        help="number of shards to split each conversion in")
+    parser.add_argument("--jobs", type=int, default=1,
+                        help="number of shards to run at the same time")
+    parser.add_argument("--log-dir", default="exhaustive_logs",
+                        help="where to write the output of each shard")
+    parser.add_argument("--merge", nargs="+", metavar="LOG",
+                        help="only merge the results of existing shard logs")
+    parser.add_argument("command", nargs="*",
+                        help="test_conversions command line to run")
+    args = parser.parse_args()
+
+    if args.merge:
+        return merge(args.merge)
+
+    if not args.command:
+        parser.error("a test_conversions command line is required")
+    if args.shards < 1 or args.jobs < 1:
+        parser.error("--shards and --jobs must be at least 1")
+
+    return merge(run_shards(args.command, args.shards, args.jobs,
+                            args.log_dir))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -151,12 +151,16 @@ int main(int argc, const char **argv)
         if (error) vlog_error("clFinish failed: %d\n", error);
     }
 
-    clReleaseMemObject(gInBuffer);
-
-    for (int i = 0; i < kCallStyleCount; i++)
+    for (int b = 0; b < gPipelineDepth; b++)
     {
-        clReleaseMemObject(gOutBuffers[i]);
+        clReleaseMemObject(gInBuffers[b]);
+
+        for (int i = 0; i < kCallStyleCount; i++)
+        {
+            clReleaseMemObject(gOutBuffers[b][i]);
+        }
     }
+    conv_test::ReleaseBatchedProgram();
     clReleaseCommandQueue(gQueue);
     clReleaseContext(gContext);
 
@@ -207,7 +211,25 @@ static int ParseArgs(int argc, const char **argv)
         if (NULL == arg) break;
 
         vlog("\t%s", arg);
-        if (arg[0] == '-')
+        if (0 == strcmp(arg, "--exhaustive"))
+        {
+            gExhaustive = 1;
+        }
+        else if (0 == strcmp(arg, "--shard"))
+        {
+            if (i + 1 >= argc
+                || 2 != sscanf(argv[i + 1], "%d/%d", &gShardIndex,
+                               &gShardCount)
+                || gShardCount < 1 || gShardIndex < 0
+                || gShardIndex >= gShardCount)
+            {
+                vlog(" <-- --shard expects i/N with 0 <= i < N\n");
+                PrintUsage();
+                return -1;
+            }
+            vlog("\t%s", argv[++i]);
+        }
+        else if (arg[0] == '-')
         {
             arg++;
             while (*arg != '\0')
@@ -218,6 +240,8 @@ static int ParseArgs(int argc, const char **argv)
                     case 'h': gTestHalfs ^= 1; break;
                     case 'l': gSkipTesting ^= 1; break;
                     case 'm': gMultithread ^= 1; break;
+                    case 'p': gPipelineDepth = 1; break;
+                    case 'r': gSimdReference ^= 1; break;
                     case 'w': gWimpyMode ^= 1; break;
                     case '[':
                         parseWimpyReductionFactor(arg, gWimpyReductionFactor);
@@ -228,6 +252,7 @@ static int ParseArgs(int argc, const char **argv)
                         break;
                     case 't': gTimeResults ^= 1; break;
                     case 'a': gReportAverageTimes ^= 1; break;
+                    case 'b': gBatchPrograms ^= 1; break;
                     case '1':
                         if (arg[1] == '6')
                         {
@@ -297,6 +322,13 @@ static int ParseArgs(int argc, const char **argv)
         gWimpyMode = 1;
     }
 
+    if (gExhaustive && gWimpyMode)
+    {
+        vlog("\n");
+        vlog("*** Wimpy mode ignored in exhaustive mode               ***\n");
+        gWimpyMode = 0;
+    }
+
     vlog("\n");
 
     PrintArch();
@@ -332,11 +364,20 @@ static void PrintUsage(void)
     vlog("\t\t\t\tchar_sat_rte_float   converts float to char with saturated "
          "clipping in round to nearest rounding mode\n\n");
     vlog("\toptions:\n");
+    vlog("\t\t-b\tToggle building the kernels for all vector sizes, "
+         "saturation and rounding modes of a type pair in one program.\n");
     vlog("\t\t-d\tToggle testing of double precision.  On by default if "
          "cl_khr_fp64 is enabled, ignored otherwise.\n");
     vlog("\t\t-l\tToggle link check mode. When on, testing is skipped, and we "
          "just check to see that the kernels build. (Off by default.)\n");
     vlog("\t\t-m\tToggle Multithreading. (On by default.)\n");
+    vlog("\t\t-p\tDon't overlap input generation and verification of one "
+         "block with the conversion of the next.\n");
+    vlog("\t\t-r\tToggle vectorized reference conversions. (On by default.)\n");
+    vlog("\t\t--exhaustive\tTest every input of types up to 32 bits, "
+         "ignoring wimpy mode and the embedded profile reduction.\n");
+    vlog("\t\t--shard i/N\tOnly test every N-th block of inputs, starting "
+         "at block i. See run_exhaustive.py.\n");
     vlog("\t\t-w\tToggle wimpy mode. When wimpy mode is on, we run a very "
          "small subset of the tests for each fn. NOT A VALID TEST! (Off by "
          "default.)\n");
@@ -483,36 +524,44 @@ test_status InitCL(cl_device_id device)
 
     // Allocate buffers
     // FIXME: use clProtectedArray for guarded allocations?
-    gIn = malloc(BUFFER_SIZE + 2 * kPageSize);
-    gAllowZ = malloc(BUFFER_SIZE + 2 * kPageSize);
-    gRef = malloc(BUFFER_SIZE + 2 * kPageSize);
+    for (int b = 0; b < gPipelineDepth; b++)
+    {
+        gIn[b] = malloc(BUFFER_SIZE + 2 * kPageSize);
+        gAllowZ[b] = malloc(BUFFER_SIZE + 2 * kPageSize);
+        gRef[b] = malloc(BUFFER_SIZE + 2 * kPageSize);
+        if (NULL == gIn[b] || NULL == gAllowZ[b] || NULL == gRef[b])
+            return TEST_FAIL;
+    }
     for (i = 0; i < kCallStyleCount; i++)
     {
         gOut[i] = malloc(BUFFER_SIZE + 2 * kPageSize);
         if (NULL == gOut[i]) return TEST_FAIL;
     }
 
-    // setup input buffers
-    gInBuffer =
-        clCreateBuffer(gContext, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR,
-                       BUFFER_SIZE, NULL, &error);
-    if (gInBuffer == NULL || error)
-    {
-        vlog_error("clCreateBuffer failed for input (%d)\n", error);
-        return TEST_FAIL;
-    }
-
-    // setup output buffers
-    for (i = 0; i < kCallStyleCount; i++)
+    for (int b = 0; b < gPipelineDepth; b++)
     {
-        gOutBuffers[i] =
-            clCreateBuffer(gContext, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+        // setup input buffers
+        gInBuffers[b] =
+            clCreateBuffer(gContext, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR,
                            BUFFER_SIZE, NULL, &error);
-        if (gOutBuffers[i] == NULL || error)
+        if (gInBuffers[b] == NULL || error)
         {
-            vlog_error("clCreateArray failed for output (%d)\n", error);
+            vlog_error("clCreateBuffer failed for input (%d)\n", error);
             return TEST_FAIL;
         }
+
+        // setup output buffers
+        for (i = 0; i < kCallStyleCount; i++)
+        {
+            gOutBuffers[b][i] = clCreateBuffer(
+                gContext, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+                BUFFER_SIZE, NULL, &error);
+            if (gOutBuffers[b][i] == NULL || error)
+            {
+                vlog_error("clCreateArray failed for output (%d)\n", error);
+                return TEST_FAIL;
+            }
+        }
     }
 
     char c[1024];
@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "harness/parseParameters.h"
 #include "harness/testHarness.h"
 
 #if !defined(_WIN32)
@@ -63,8 +64,17 @@ test_status InitCL(cl_device_id device)
     return TEST_PASS;
 }
 
+cl_uint gDriftSeconds = 0;
+
 int main(int argc, const char *argv[])
 {
+    argc = parseSuiteOptions(
+        argc, argv, "Device timer",
+        { { "--drift", "<seconds>", &gDriftSeconds,
+            "Run device_timer_drift, sampling the timers for this long idle "
+            "and under CPU load" } });
+    if (argc < 0) return EXIT_FAILURE;
+
     return runTestHarnessWithCheck(
         argc, argv, test_registry::getInstance().num_tests(),
         test_registry::getInstance().definitions(), false, 0, InitCL);
@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <CL/cl.h>
+#include "harness/errorHelpers.h"
+#include "harness/compat.h"
+#include "harness/testHarness.h"
+#include "harness/benchmarkHelpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// Length of each device_timer_drift phase, 0 to skip the test
+extern cl_uint gDriftSeconds;
+
+namespace {
+
+// Same tolerance as device_and_host_timers, in parts per million
+const double kMaxDriftPpm = 5000.0;
+
+// Time between two timer pairs
+const std::chrono::milliseconds kSampleInterval(2);
+
+struct TimerSample
+{
+    cl_ulong device;
+    cl_ulong host;
+};
+
+struct DriftSamples
+{
+    std::vector<TimerSample> pairs;
+    std::vector<cl_ulong> pairLatency; // clGetDeviceAndHostTimer, ns
+    std::vector<cl_ulong> hostLatency; // clGetHostTimer, ns
+};
+
+int collect_samples(cl_device_id device, DriftSamples &samples)
+{
+    const auto end =
+        BenchmarkClock::now() + std::chrono::seconds(gDriftSeconds);
+    while (BenchmarkClock::now() < end)
+    {
+        TimerSample sample;
+        auto start = BenchmarkClock::now();
+        cl_int error =
+            clGetDeviceAndHostTimer(device, &sample.device, &sample.host);
+        samples.pairLatency.push_back(
+            host_elapsed_ns(start, BenchmarkClock::now()));
+        test_error(error, "clGetDeviceAndHostTimer failed");
+
+        if (!samples.pairs.empty()
+            && (sample.device < samples.pairs.back().device
+                || sample.host < samples.pairs.back().host))
+        {
+            log_error("ERROR: timers went backwards: device %" PRIu64
+                      " -> %" PRIu64 ", host %" PRIu64 " -> %" PRIu64 "\n",
+                      samples.pairs.back().device, sample.device,
+                      samples.pairs.back().host, sample.host);
+            return -1;
+        }
+        samples.pairs.push_back(sample);
+
+        cl_ulong hostTime;
+        start = BenchmarkClock::now();
+        error = clGetHostTimer(device, &hostTime);
+        samples.hostLatency.push_back(
+            host_elapsed_ns(start, BenchmarkClock::now()));
+        test_error(error, "clGetHostTimer failed");
+
+        std::this_thread::sleep_for(kSampleInterval);
+    }
+    return CL_SUCCESS;
+}
+
+void report_latency(const char *phase, const char *query,
+                    std::vector<cl_ulong> ns)
+{
+    std::sort(ns.begin(), ns.end());
+    log_info("QUERY_LATENCY %s %s us p50 %.2f p90 %.2f p99 %.2f max %.2f\n",
+             phase, query, sorted_percentile(ns, 50) * 1e-3,
+             sorted_percentile(ns, 90) * 1e-3,
+             sorted_percentile(ns, 99) * 1e-3, ns.back() * 1e-3);
+}
+
+// Least squares fit of device = offset + rate * host. The drift is how far
+// the rate is from 1 and the jitter is what the line does not explain.
+int report_drift(const char *phase, const DriftSamples &samples)
+{
+    const std::vector<TimerSample> &pairs = samples.pairs;
+    if (pairs.size() < 2)
+    {
+        log_error("ERROR: only %zu timer samples in the %s phase\n",
+                  pairs.size(), phase);
+        return -1;
+    }
+
+    // Relative to the first pair, so the doubles keep nanoseconds
+    const size_t n = pairs.size();
+    double meanX = 0, meanY = 0;
+    for (const TimerSample &s : pairs)
+    {
+        meanX += (double)(s.host - pairs[0].host) / n;
+        meanY += (double)(s.device - pairs[0].device) / n;
+    }
+    double sxx = 0, sxy = 0;
+    for (const TimerSample &s : pairs)
+    {
+        double x = (double)(s.host - pairs[0].host) - meanX;
+        double y = (double)(s.device - pairs[0].device) - meanY;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    double rate = sxy / sxx;
+    double sumSquares = 0, maxResidual = 0;
+    for (const TimerSample &s : pairs)
+    {
+        double x = (double)(s.host - pairs[0].host) - meanX;
+        double y = (double)(s.device - pairs[0].device) - meanY;
+        double residual = y - rate * x;
+        sumSquares += residual * residual;
+        maxResidual = std::max(maxResidual, std::fabs(residual));
+    }
+    double driftPpm = (rate - 1.0) * 1e6;
+
+    log_info("DRIFT %s samples %zu span_s %.1f drift_ppm %.3f jitter_rms_ns "
+             "%.1f jitter_max_ns %.1f\n",
+             phase, n, (pairs.back().host - pairs[0].host) * 1e-9, driftPpm,
+             std::sqrt(sumSquares / n), maxResidual);
+    report_latency(phase, "clGetDeviceAndHostTimer", samples.pairLatency);
+    report_latency(phase, "clGetHostTimer", samples.hostLatency);
+
+    if (std::fabs(driftPpm) > kMaxDriftPpm)
+    {
+        log_error("ERROR: device timer drifts %.1f ppm from the host timer "
+                  "(max allowed %.1f)\n",
+                  driftPpm, kMaxDriftPpm);
+        return -1;
+    }
+    return CL_SUCCESS;
+}
+
+}
+
+REGISTER_TEST(device_timer_drift)
+{
+    if (gDriftSeconds == 0)
+    {
+        log_info("Skipping, the timer drift benchmark only runs with "
+                 "'--drift <seconds>'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    log_info("Sampling timers for %u s idle and %u s under CPU load\n",
+             gDriftSeconds, gDriftSeconds);
+    DriftSamples idle;
+    int error = collect_samples(device, idle);
+    if (error) return error;
+    error = report_drift("idle", idle);
+
+    // Keep every hardware thread busy while sampling again
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> load;
+    unsigned threads = std::max(1U, std::thread::hardware_concurrency());
+    for (unsigned t = 0; t < threads; t++)
+        load.emplace_back([&stop]() {
+            volatile cl_ulong spin = 0;
+            while (!stop.load(std::memory_order_relaxed)) spin = spin + 1;
+        });
+    DriftSamples loaded;
+    int loadError = collect_samples(device, loaded);
+    stop = true;
+    for (std::thread &t : load) t.join();
+    if (loadError) return loadError;
+
+    error |= report_drift("cpu_load", loaded);
+    return error;
+}
@@ -13,10 +13,20 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
-#include "harness/testHarness.h"
+#include "testBase.h"
+#include "harness/parseParameters.h"
+
+cl_uint gEventGraphMaxNodes = 0;
 
 int main(int argc, const char *argv[])
 {
+    argc = parseSuiteOptions(
+        argc, argv, "Events",
+        { { "--event-graph-max-nodes", "<n>", &gEventGraphMaxNodes,
+            "Run event_graph_stress on random graphs of up to this many "
+            "nodes" } });
+    if (argc < 0) return EXIT_FAILURE;
+
     return runTestHarness(argc, argv, test_registry::getInstance().num_tests(),
                           test_registry::getInstance().definitions(), false, 0);
 }
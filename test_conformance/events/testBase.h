@@ -20,4 +20,7 @@
 #include "harness/testHarness.h"
 #include "harness/typeWrappers.h"
 
+// Largest random graph built by event_graph_stress, 0 to skip the test
+extern cl_uint gEventGraphMaxNodes;
+
 #endif // _testBase_h
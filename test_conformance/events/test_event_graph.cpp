@@ -0,0 +1,282 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+
+#include "harness/mt19937.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+// Each node of the graph takes the next ticket from a shared counter, so the
+// tickets give the order in which the nodes ran.
+const char *graph_node_source =
+    "__kernel void graph_node(volatile __global uint *counter,\n"
+    "                         __global uint *tickets, uint node)\n"
+    "{\n"
+    "    tickets[node] = atomic_inc(counter);\n"
+    "}\n";
+
+const int kGraphQueues = 4;
+const int kGraphUserEvents = 8;
+
+// Size of the first graph, the following ones double up to the largest
+const cl_uint kMinGraphNodes = 256;
+
+// A node depends on up to kMaxFanIn random nodes among the kWindow before it,
+// and on the last hub node. Every kHubInterval-th node is a hub, so hubs fan
+// out to kHubInterval nodes.
+const cl_uint kMaxFanIn = 8;
+const cl_uint kWindow = 256;
+const cl_uint kHubInterval = 64;
+
+// One user event gates every kUserEventInterval-th node
+const cl_uint kUserEventInterval = 97;
+
+struct GraphNode
+{
+    int queue;
+    int userEvent; // -1 if the node does not wait for a user event
+    std::vector<cl_uint> preds;
+};
+
+std::vector<GraphNode> generate_graph(cl_uint numNodes, MTdata d)
+{
+    std::vector<GraphNode> nodes(numNodes);
+    for (cl_uint i = 0; i < numNodes; i++)
+    {
+        GraphNode &node = nodes[i];
+        node.queue = genrand_int32(d) % kGraphQueues;
+        node.userEvent =
+            i % kUserEventInterval == 0 ? genrand_int32(d) % kGraphUserEvents
+                                        : -1;
+        if (i == 0) continue;
+
+        cl_uint first = i > kWindow ? i - kWindow : 0;
+        cl_uint fanIn = genrand_int32(d) % (kMaxFanIn + 1);
+        for (cl_uint k = 0; k < fanIn; k++)
+            node.preds.push_back(first + genrand_int32(d) % (i - first));
+        if (i % kHubInterval)
+            node.preds.push_back(i / kHubInterval * kHubInterval);
+
+        std::sort(node.preds.begin(), node.preds.end());
+        node.preds.erase(std::unique(node.preds.begin(), node.preds.end()),
+                         node.preds.end());
+    }
+    return nodes;
+}
+
+struct GraphTimes
+{
+    size_t edges;
+    double enqueueSeconds;
+    double executeSeconds;
+};
+
+int run_graph(cl_context context, cl_command_queue *queues, cl_kernel kernel,
+              const std::vector<GraphNode> &nodes, GraphTimes &times)
+{
+    typedef std::chrono::steady_clock Clock;
+    const cl_uint numNodes = (cl_uint)nodes.size();
+    int error;
+
+    clMemWrapper counter = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                          sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create counter buffer");
+    clMemWrapper tickets = clCreateBuffer(
+        context, CL_MEM_READ_WRITE, numNodes * sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create ticket buffer");
+    const cl_uint zero = 0;
+    error = clEnqueueWriteBuffer(queues[0], counter, CL_TRUE, 0, sizeof(zero),
+                                 &zero, 0, NULL, NULL);
+    test_error(error, "Unable to clear counter");
+    error = clSetKernelArg(kernel, 0, sizeof(counter), &counter);
+    error |= clSetKernelArg(kernel, 1, sizeof(tickets), &tickets);
+    test_error(error, "Unable to set kernel arguments");
+
+    clEventWrapper userEvents[kGraphUserEvents];
+    for (int u = 0; u < kGraphUserEvents; u++)
+    {
+        userEvents[u] = clCreateUserEvent(context, &error);
+        test_error(error, "Unable to create user event");
+    }
+    // Fails the user events on the error paths, so that the nodes waiting on
+    // them terminate instead of keeping the queues busy forever.
+    struct UserEventGuard
+    {
+        clEventWrapper *events;
+        bool armed;
+        ~UserEventGuard()
+        {
+            if (!armed) return;
+            for (int u = 0; u < kGraphUserEvents; u++)
+                clSetUserEventStatus(events[u], -1);
+        }
+    } guard = { userEvents, true };
+
+    // The nodes gated by user events cannot run before the events are set,
+    // and neither can the nodes that depend on them, so much of the graph is
+    // still pending while it is built. The other nodes may already run.
+    std::vector<clEventWrapper> events(numNodes);
+    std::vector<cl_event> waitList;
+    const size_t globalSize = 1;
+    times.edges = 0;
+    auto start = Clock::now();
+    for (cl_uint i = 0; i < numNodes; i++)
+    {
+        const GraphNode &node = nodes[i];
+        waitList.clear();
+        for (cl_uint p : node.preds) waitList.push_back(events[p]);
+        if (node.userEvent >= 0) waitList.push_back(userEvents[node.userEvent]);
+        times.edges += waitList.size();
+
+        error = clSetKernelArg(kernel, 2, sizeof(i), &i);
+        test_error(error, "Unable to set kernel arguments");
+        error = clEnqueueNDRangeKernel(
+            queues[node.queue], kernel, 1, NULL, &globalSize, NULL,
+            (cl_uint)waitList.size(), waitList.empty() ? NULL : &waitList[0],
+            &events[i]);
+        test_error(error, "Unable to enqueue graph node");
+    }
+    for (int q = 0; q < kGraphQueues; q++)
+    {
+        error = clFlush(queues[q]);
+        test_error(error, "clFlush failed");
+    }
+    auto enqueued = Clock::now();
+
+    for (int u = kGraphUserEvents - 1; u >= 0; u--)
+    {
+        error = clSetUserEventStatus(userEvents[u], CL_COMPLETE);
+        test_error(error, "Unable to complete user event");
+    }
+    guard.armed = false;
+    for (int q = 0; q < kGraphQueues; q++)
+    {
+        error = clFinish(queues[q]);
+        test_error(error, "clFinish failed");
+    }
+    auto finished = Clock::now();
+    times.enqueueSeconds =
+        std::chrono::duration<double>(enqueued - start).count();
+    times.executeSeconds =
+        std::chrono::duration<double>(finished - enqueued).count();
+
+    std::vector<cl_uint> order(numNodes);
+    cl_uint ran;
+    error = clEnqueueReadBuffer(queues[0], tickets, CL_TRUE, 0,
+                                numNodes * sizeof(cl_uint), order.data(), 0,
+                                NULL, NULL);
+    error |= clEnqueueReadBuffer(queues[0], counter, CL_TRUE, 0, sizeof(ran),
+                                 &ran, 0, NULL, NULL);
+    test_error(error, "Unable to read tickets");
+
+    if (ran != numNodes)
+    {
+        log_error("ERROR: %u of %u graph nodes ran\n", ran, numNodes);
+        return -1;
+    }
+    int errors = 0;
+    for (cl_uint i = 0; i < numNodes; i++)
+    {
+        for (cl_uint p : nodes[i].preds)
+        {
+            if (order[p] < order[i]) continue;
+            if (errors++ < 10)
+                log_error("ERROR: node %u ran as #%u, before node %u it "
+                          "depends on (#%u)\n",
+                          i, order[i], p, order[p]);
+        }
+    }
+    if (errors)
+    {
+        log_error("ERROR: %d dependencies were not respected\n", errors);
+        return -1;
+    }
+    return CL_SUCCESS;
+}
+
+}
+
+REGISTER_TEST(event_graph_stress)
+{
+    if (gEventGraphMaxNodes == 0)
+    {
+        log_info("Skipping, the event graph stress test only runs with "
+                 "'--event-graph-max-nodes <n>'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    int error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                            &graph_node_source, "graph_node");
+    test_error(error, "Unable to create graph node kernel");
+
+    // Cross-queue edges need more than the one queue of the harness
+    clCommandQueueWrapper ownQueues[kGraphQueues - 1];
+    cl_command_queue queues[kGraphQueues] = { queue };
+    for (int q = 1; q < kGraphQueues; q++)
+    {
+        ownQueues[q - 1] = clCreateCommandQueue(context, device, 0, &error);
+        test_error(error, "Unable to create queue");
+        queues[q] = ownQueues[q - 1];
+    }
+
+    MTdataHolder d(gRandomSeed);
+    log_info("Random graphs over %d queues, seed %u\n", kGraphQueues,
+             gRandomSeed);
+    double firstEnqueuePerEdge = 0;
+    cl_uint firstNodes = 0;
+    cl_uint numNodes = std::min(kMinGraphNodes, gEventGraphMaxNodes);
+    while (true)
+    {
+        std::vector<GraphNode> nodes = generate_graph(numNodes, d);
+        GraphTimes times;
+        error = run_graph(context, queues, kernel, nodes, times);
+        if (error) return error;
+
+        double enqueuePerEdge = times.enqueueSeconds * 1e9 / times.edges;
+        log_info("\t%6u nodes %7zu edges: enqueue %8.1f ns/edge, execute "
+                 "%8.1f ns/edge\n",
+                 numNodes, times.edges, enqueuePerEdge,
+                 times.executeSeconds * 1e9 / times.edges);
+
+        if (!firstNodes)
+        {
+            firstNodes = numNodes;
+            firstEnqueuePerEdge = enqueuePerEdge;
+        }
+        else if (enqueuePerEdge > 4 * firstEnqueuePerEdge)
+        {
+            // Timing is too noisy to fail on, but a cost per edge that grows
+            // with the graph points at event tracking that does not scale.
+            log_info("WARNING: enqueue cost per edge grew %.1fx from %u to %u "
+                     "nodes\n",
+                     enqueuePerEdge / firstEnqueuePerEdge, firstNodes,
+                     numNodes);
+        }
+
+        // The last graph has exactly the largest size, and doubling stops
+        // before it could overflow
+        if (numNodes == gEventGraphMaxNodes) break;
+        numNodes = numNodes > gEventGraphMaxNodes / 2 ? gEventGraphMaxNodes
+                                                      : 2 * numNodes;
+    }
+    return 0;
+}
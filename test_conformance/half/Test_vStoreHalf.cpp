@@ -31,6 +31,7 @@ typedef struct ComputeReferenceInfoF_
     float *x;
     cl_ushort *r;
     f2h f;
+    f2h_array fa;
     cl_ulong i;
     cl_uint lim;
     cl_uint count;
@@ -84,11 +85,12 @@ static cl_int ReferenceF(cl_uint jid, cl_uint tid, void *userInfo)
 
     if (off + count > lim) count = lim - off;
 
-    for (j = 0; j < count; ++j)
-    {
-        x[j] = as_float((cl_uint)(i + j));
-        r[j] = f(x[j]);
-    }
+    for (j = 0; j < count; ++j) x[j] = as_float((cl_uint)(i + j));
+
+    if (cri->fa)
+        cri->fa(r, x, count);
+    else
+        for (j = 0; j < count; ++j) r[j] = f(x[j]);
 
     return 0;
 }
@@ -253,35 +255,41 @@ REGISTER_TEST(vstore_half)
     {
         case CL_FP_ROUND_TO_ZERO:
             return Test_vStoreHalf_private(device, float2half_rtz,
+                                           float2half_array_rtz,
                                            double2half_rte, "");
         case 0: return -1;
         default:
             return Test_vStoreHalf_private(device, float2half_rte,
+                                           float2half_array_rte,
                                            double2half_rte, "");
     }
 }
 
 REGISTER_TEST(vstore_half_rte)
 {
-    return Test_vStoreHalf_private(device, float2half_rte, double2half_rte,
+    return Test_vStoreHalf_private(device, float2half_rte,
+                                   float2half_array_rte, double2half_rte,
                                    "_rte");
 }
 
 REGISTER_TEST(vstore_half_rtz)
 {
-    return Test_vStoreHalf_private(device, float2half_rtz, double2half_rtz,
+    return Test_vStoreHalf_private(device, float2half_rtz,
+                                   float2half_array_rtz, double2half_rtz,
                                    "_rtz");
 }
 
 REGISTER_TEST(vstore_half_rtp)
 {
-    return Test_vStoreHalf_private(device, float2half_rtp, double2half_rtp,
+    return Test_vStoreHalf_private(device, float2half_rtp,
+                                   float2half_array_rtp, double2half_rtp,
                                    "_rtp");
 }
 
 REGISTER_TEST(vstore_half_rtn)
 {
-    return Test_vStoreHalf_private(device, float2half_rtn, double2half_rtn,
+    return Test_vStoreHalf_private(device, float2half_rtn,
+                                   float2half_array_rtn, double2half_rtn,
                                    "_rtn");
 }
 
@@ -291,41 +299,133 @@ REGISTER_TEST(vstorea_half)
     {
         case CL_FP_ROUND_TO_ZERO:
             return Test_vStoreaHalf_private(device, float2half_rtz,
+                                            float2half_array_rtz,
                                             double2half_rte, "");
         case 0: return -1;
         default:
             return Test_vStoreaHalf_private(device, float2half_rte,
+                                            float2half_array_rte,
                                             double2half_rte, "");
     }
 }
 
 REGISTER_TEST(vstorea_half_rte)
 {
-    return Test_vStoreaHalf_private(device, float2half_rte, double2half_rte,
+    return Test_vStoreaHalf_private(device, float2half_rte,
+                                    float2half_array_rte, double2half_rte,
                                     "_rte");
 }
 
 REGISTER_TEST(vstorea_half_rtz)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtz, double2half_rtz,
+    return Test_vStoreaHalf_private(device, float2half_rtz,
+                                    float2half_array_rtz, double2half_rtz,
                                     "_rtz");
 }
 
 REGISTER_TEST(vstorea_half_rtp)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtp, double2half_rtp,
+    return Test_vStoreaHalf_private(device, float2half_rtp,
+                                    float2half_array_rtp, double2half_rtp,
                                     "_rtp");
 }
 
 REGISTER_TEST(vstorea_half_rtn)
 {
-    return Test_vStoreaHalf_private(device, float2half_rtn, double2half_rtn,
+    return Test_vStoreaHalf_private(device, float2half_rtn,
+                                    float2half_array_rtn, double2half_rtn,
                                     "_rtn");
 }
 
 #pragma mark -
 
+// Queue the kernels of every vector size and address space for one block of
+// inputs, and check their results as they come back.
+static int TestBlock(cl_device_id device, PipelinedExecutor &executor,
+                     cl_kernel kernels[][3], cl_kernel doubleKernels[][3],
+                     cl_kernel resetKernel, int minVectorSize, cl_uint count,
+                     bool aligned, const CheckResultInfoF &fchk,
+                     const CheckResultInfoD &dchk)
+{
+    cl_uint threadCount = GetThreadCount();
+    size_t resultSize = count * sizeof(cl_half);
+
+    // Fill the output with junk first, so that missing stores are caught
+    auto reset = [=](cl_mem in, cl_mem out) {
+        int error;
+        if (!gHostReset)
+            error = RunKernel(device, resetKernel, in, out, count, 0);
+        else
+            error = clEnqueueWriteBuffer(gQueue, out, CL_FALSE, 0, resultSize,
+                                         gOut_half, 0, NULL, NULL);
+        if (error) vlog_error("Failure in clWriteArray\n");
+        return error;
+    };
+
+    if (gHostReset)
+    {
+        cl_uint pattern = 0xdeaddead;
+        memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
+    }
+
+    for (int vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest;
+         vectorSize++)
+    {
+        cl_uint vecs = numVecs(count, vectorSize, aligned);
+        cl_uint overBy = runsOverBy(count, vectorSize, aligned);
+
+        for (int addressSpace = 0; addressSpace < 3; addressSpace++)
+        {
+            CheckResultInfoF fjob = fchk;
+            fjob.vsz = g_arrVecSizes[vectorSize];
+            fjob.aspace = addressSpaceNames[addressSpace];
+            cl_kernel kernel = kernels[vectorSize][addressSpace];
+
+            executor.AddJob(
+                resultSize,
+                [=](cl_mem out) {
+                    int error = reset(gInBuffer_single, out);
+                    if (!error)
+                        error = RunKernel(device, kernel, gInBuffer_single, out,
+                                          vecs, overBy);
+                    return error;
+                },
+                [=](const void *result) mutable {
+                    fjob.s = (const cl_half *)result;
+                    return ThreadPool_Do(CheckF, threadCount, &fjob);
+                });
+
+            if (gTestDouble)
+            {
+                CheckResultInfoD djob = dchk;
+                djob.vsz = g_arrVecSizes[vectorSize];
+                djob.aspace = addressSpaceNames[addressSpace];
+                cl_kernel doubleKernel =
+                    doubleKernels[vectorSize][addressSpace];
+
+                executor.AddJob(
+                    resultSize,
+                    [=](cl_mem out) {
+                        int error = reset(gInBuffer_double, out);
+                        if (!error)
+                            error = RunKernel(device, doubleKernel,
+                                              gInBuffer_double, out, vecs,
+                                              overBy);
+                        return error;
+                    },
+                    [=](const void *result) mutable {
+                        djob.s = (const cl_half *)result;
+                        return ThreadPool_Do(CheckD, threadCount, &djob);
+                    });
+            }
+        }
+    }
+
+    return executor.Run();
+}
+
 int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
+                            f2h_array referenceArrayFunc,
                             d2h doubleReferenceFunc, const char *roundName)
 {
     int vectorSize, error;
@@ -864,6 +964,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     fref.x = (float *)gIn_single;
     fref.r = (cl_half *)gOut_half_reference;
     fref.f = referenceFunc;
+    fref.fa = referenceArrayFunc;
     fref.lim = blockCount;
     fref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -890,6 +991,13 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     dchk.lim = blockCount;
     dchk.count = (blockCount + threadCount - 1) / threadCount;
 
+    PipelinedExecutor executor(BUFFER_SIZE / 2, kResultPipelineDepth, &error);
+    if (error)
+    {
+        gFailCount++;
+        goto exit;
+    }
+
     for (i = 0; i < lastCase; i += stride)
     {
         count = (cl_uint)std::min((uint64_t)blockCount, lastCase - i);
@@ -924,121 +1032,13 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
             }
         }
 
-        for (vectorSize = kMinVectorSize; vectorSize < kLastVectorSizeToTest;
-             vectorSize++)
+        error = TestBlock(device, executor, kernels, doubleKernels,
+                          resetKernel, kMinVectorSize, count, aligned, fchk,
+                          dchk);
+        if (error)
         {
-            // Loop through vector sizes
-            fchk.vsz = g_arrVecSizes[vectorSize];
-            dchk.vsz = g_arrVecSizes[vectorSize];
-
-            for (addressSpace = 0; addressSpace < 3; addressSpace++)
-            {
-                // Loop over address spaces
-                fchk.aspace = addressSpaceNames[addressSpace];
-                dchk.aspace = addressSpaceNames[addressSpace];
-
-                if (!gHostReset)
-                {
-                    error = RunKernel(device, resetKernel, gInBuffer_single,
-                                      gOutBuffer_half, count, 0);
-                }
-                else
-                {
-                    cl_uint pattern = 0xdeaddead;
-                    memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                    error = clEnqueueWriteBuffer(
-                        gQueue, gOutBuffer_half, CL_FALSE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                }
-                if (error)
-                {
-                    vlog_error("Failure in clWriteArray\n");
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = RunKernel(device, kernels[vectorSize][addressSpace],
-                                  gInBuffer_single, gOutBuffer_half,
-                                  numVecs(count, vectorSize, aligned),
-                                  runsOverBy(count, vectorSize, aligned));
-                if (error)
-                {
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0,
-                                            count * sizeof(cl_half), gOut_half,
-                                            0, NULL, NULL);
-                if (error)
-                {
-                    vlog_error("Failure in clReadArray\n");
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = ThreadPool_Do(CheckF, threadCount, &fchk);
-                if (error)
-                {
-                    gFailCount++;
-                    goto exit;
-                }
-
-                if (gTestDouble)
-                {
-
-                    if (!gHostReset)
-                    {
-                        error = RunKernel(device, resetKernel, gInBuffer_double,
-                                          gOutBuffer_half, count, 0);
-                    }
-                    else
-                    {
-                        cl_uint pattern = 0xdeaddead;
-                        memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                        error = clEnqueueWriteBuffer(
-                            gQueue, gOutBuffer_half, CL_FALSE, 0,
-                            count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                    }
-                    if (error)
-                    {
-                        vlog_error("Failure in clWriteArray\n");
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = RunKernel(device,
-                                      doubleKernels[vectorSize][addressSpace],
-                                      gInBuffer_double, gOutBuffer_half,
-                                      numVecs(count, vectorSize, aligned),
-                                      runsOverBy(count, vectorSize, aligned));
-                    if (error)
-                    {
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = clEnqueueReadBuffer(
-                        gQueue, gOutBuffer_half, CL_TRUE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                    if (error)
-                    {
-                        vlog_error("Failure in clReadArray\n");
-                        gFailCount++;
-                        goto exit;
-                    }
-
-
-                    error = ThreadPool_Do(CheckD, threadCount, &dchk);
-                    if (error)
-                    {
-                        gFailCount++;
-                        goto exit;
-                    }
-                }
-            }
+            gFailCount++;
+            goto exit;
         }
 
         if (((i + blockCount) & ~printMask) == (i + blockCount))
@@ -1210,6 +1210,7 @@ exit:
 }
 
 int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
+                             f2h_array referenceArrayFunc,
                              d2h doubleReferenceFunc, const char *roundName)
 {
     int vectorSize, error;
@@ -1710,6 +1711,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     fref.x = (float *)gIn_single;
     fref.r = (cl_half *)gOut_half_reference;
     fref.f = referenceFunc;
+    fref.fa = referenceArrayFunc;
     fref.lim = blockCount;
     fref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -1736,6 +1738,13 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     dchk.lim = blockCount;
     dchk.count = (blockCount + threadCount - 1) / threadCount;
 
+    PipelinedExecutor executor(BUFFER_SIZE / 2, kResultPipelineDepth, &error);
+    if (error)
+    {
+        gFailCount++;
+        goto exit;
+    }
+
     for (i = 0; i < (uint64_t)lastCase; i += stride)
     {
         count = (cl_uint)std::min((uint64_t)blockCount, lastCase - i);
@@ -1770,121 +1779,14 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
             }
         }
 
-        for (vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest;
-             vectorSize++)
+        error = TestBlock(device, executor, kernels, doubleKernels,
+                          resetKernel, minVectorSize, count, aligned, fchk,
+                          dchk);
+        if (error)
         {
-            // Loop over vector legths
-            fchk.vsz = g_arrVecSizes[vectorSize];
-            dchk.vsz = g_arrVecSizes[vectorSize];
-
-            for (addressSpace = 0; addressSpace < 3; addressSpace++)
-            {
-                // Loop over address spaces
-                fchk.aspace = addressSpaceNames[addressSpace];
-                dchk.aspace = addressSpaceNames[addressSpace];
-
-                if (!gHostReset)
-                {
-                    error = RunKernel(device, resetKernel, gInBuffer_single,
-                                      gOutBuffer_half, count, 0);
-                }
-                else
-                {
-                    cl_uint pattern = 0xdeaddead;
-                    memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                    error = clEnqueueWriteBuffer(
-                        gQueue, gOutBuffer_half, CL_FALSE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                }
-                if (error)
-                {
-                    vlog_error("Failure in clWriteArray\n");
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = RunKernel(device, kernels[vectorSize][addressSpace],
-                                  gInBuffer_single, gOutBuffer_half,
-                                  numVecs(count, vectorSize, aligned),
-                                  runsOverBy(count, vectorSize, aligned));
-                if (error)
-                {
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0,
-                                            count * sizeof(cl_half), gOut_half,
-                                            0, NULL, NULL);
-                if (error)
-                {
-                    vlog_error("Failure in clReadArray\n");
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = ThreadPool_Do(CheckF, threadCount, &fchk);
-                if (error)
-                {
-                    gFailCount++;
-                    goto exit;
-                }
-
-                if (gTestDouble)
-                {
-
-                    if (!gHostReset)
-                    {
-                        error = RunKernel(device, resetKernel, gInBuffer_single,
-                                          gOutBuffer_half, count, 0);
-                    }
-                    else
-                    {
-                        cl_uint pattern = 0xdeaddead;
-                        memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                        error = clEnqueueWriteBuffer(
-                            gQueue, gOutBuffer_half, CL_FALSE, 0,
-                            count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                    }
-                    if (error)
-                    {
-                        vlog_error("Failure in clWriteArray\n");
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = RunKernel(device,
-                                      doubleKernels[vectorSize][addressSpace],
-                                      gInBuffer_double, gOutBuffer_half,
-                                      numVecs(count, vectorSize, aligned),
-                                      runsOverBy(count, vectorSize, aligned));
-                    if (error)
-                    {
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = clEnqueueReadBuffer(
-                        gQueue, gOutBuffer_half, CL_TRUE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                    if (error)
-                    {
-                        vlog_error("Failure in clReadArray\n");
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = ThreadPool_Do(CheckD, threadCount, &dchk);
-                    if (error)
-                    {
-                        gFailCount++;
-                        goto exit;
-                    }
-                }
-            }
-        } // end for vector size
+            gFailCount++;
+            goto exit;
+        }
 
         if (((i + blockCount) & ~printMask) == (i + blockCount))
         {
@@ -26,6 +26,8 @@
 
 #include "harness/testHarness.h"
 
+#include <algorithm>
+
 #define HALF_MIN 1.0p-14
 
 
@@ -429,3 +431,132 @@ cl_ulong getBufferCount(cl_device_id device_id, size_t vecSize, size_t typeSize)
     }
     return tmp/(cl_ulong)(vecSize*typeSize);
 }
+
+void float2half_array_rte(cl_ushort *out, const float *in, size_t count)
+{
+    convert_floats_to_halves(out, in, count, CL_HALF_RTE);
+}
+
+void float2half_array_rtz(cl_ushort *out, const float *in, size_t count)
+{
+    convert_floats_to_halves(out, in, count, CL_HALF_RTZ);
+}
+
+void float2half_array_rtp(cl_ushort *out, const float *in, size_t count)
+{
+    convert_floats_to_halves(out, in, count, CL_HALF_RTP);
+}
+
+void float2half_array_rtn(cl_ushort *out, const float *in, size_t count)
+{
+    convert_floats_to_halves(out, in, count, CL_HALF_RTN);
+}
+
+PipelinedExecutor::PipelinedExecutor(size_t maxResultSize, size_t depth,
+                                     int *error)
+    : maxResultSize(maxResultSize), slots(depth)
+{
+    *error = 0;
+    for (auto &slot : slots)
+    {
+        slot.buffer = NULL;
+        slot.result = NULL;
+        slot.readDone = NULL;
+    }
+
+    for (auto &slot : slots)
+    {
+        slot.buffer = clCreateBuffer(gContext, CL_MEM_READ_WRITE,
+                                     maxResultSize, NULL, error);
+        if (*error)
+        {
+            vlog_error("Failure in clCreateBuffer for the result pipeline "
+                       "(%d)\n",
+                       *error);
+            return;
+        }
+        slot.result = align_malloc(maxResultSize, kPageSize);
+        if (NULL == slot.result)
+        {
+            vlog_error("Failure allocating the result pipeline\n");
+            *error = -1;
+            return;
+        }
+    }
+}
+
+PipelinedExecutor::~PipelinedExecutor()
+{
+    for (auto &slot : slots)
+    {
+        if (slot.buffer) clReleaseMemObject(slot.buffer);
+        align_free(slot.result);
+    }
+}
+
+void PipelinedExecutor::AddJob(size_t resultSize, EnqueueFunc enqueue,
+                               CheckFunc check)
+{
+    jobs.push_back({ std::min(resultSize, maxResultSize), enqueue, check });
+}
+
+int PipelinedExecutor::Issue(Slot &slot, const Job &job)
+{
+    int error = job.enqueue(slot.buffer);
+    if (error) return error;
+
+    error = clEnqueueReadBuffer(gQueue, slot.buffer, CL_FALSE, 0,
+                                job.resultSize, slot.result, 0, NULL,
+                                &slot.readDone);
+    if (error) vlog_error("Failure in clReadArray\n");
+    return error;
+}
+
+int PipelinedExecutor::Run(void)
+{
+    size_t depth = slots.size();
+    size_t issued = 0;
+    int error = 0;
+
+    // fill the pipeline
+    for (; !error && issued < jobs.size() && issued < depth; issued++)
+        error = Issue(slots[issued], jobs[issued]);
+    if (!error) error = clFlush(gQueue);
+
+    // check each job as it completes and put the next one in its slot
+    for (size_t j = 0; !error && j < jobs.size(); j++)
+    {
+        Slot &slot = slots[j % depth];
+        error = clWaitForEvents(1, &slot.readDone);
+        clReleaseEvent(slot.readDone);
+        slot.readDone = NULL;
+        if (error)
+        {
+            vlog_error("Failure in clReadArray\n");
+            break;
+        }
+
+        if ((error = jobs[j].check(slot.result))) break;
+
+        if (issued < jobs.size())
+        {
+            if ((error = Issue(slot, jobs[issued++]))) break;
+            error = clFlush(gQueue);
+        }
+    }
+
+    // don't leave anything in flight on failure
+    if (error)
+    {
+        clFinish(gQueue);
+        for (auto &slot : slots)
+            if (slot.readDone)
+            {
+                clReleaseEvent(slot.readDone);
+                slot.readDone = NULL;
+            }
+    }
+
+    jobs.clear();
+    return error;
+}
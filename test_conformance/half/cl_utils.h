@@ -22,6 +22,9 @@
 
 #include <stdio.h>
 
+#include <functional>
+#include <vector>
+
 #if !defined(_WIN32)
 #include <sys/param.h>
 #endif
@@ -111,6 +114,57 @@ static inline cl_ulong DoubleFromUInt( cl_uint bits )
     return u;
 }
 
+// Bulk float -> half conversions with the given rounding, as f2h_array
+// references for the vstore_half tests.
+void float2half_array_rte( cl_ushort *out, const float *in, size_t count );
+void float2half_array_rtz( cl_ushort *out, const float *in, size_t count );
+void float2half_array_rtp( cl_ushort *out, const float *in, size_t count );
+void float2half_array_rtn( cl_ushort *out, const float *in, size_t count );
+
+// Runs kernel jobs that each leave their result in a device buffer and checks
+// those results on the host as soon as they have been read back. Up to depth
+// jobs are queued on the device at a time, so the kernels of later jobs
+// overlap with checking the earlier ones.
+class PipelinedExecutor
+{
+public:
+    // Enqueues the work of a job, writing its result to out
+    typedef std::function<int( cl_mem out )> EnqueueFunc;
+    // Checks the result of a job once it is on the host
+    typedef std::function<int( const void *result )> CheckFunc;
+
+    // Sets error if the result buffers can't be allocated
+    PipelinedExecutor( size_t maxResultSize, size_t depth, int *error );
+    ~PipelinedExecutor();
+
+    void AddJob( size_t resultSize, EnqueueFunc enqueue, CheckFunc check );
+
+    // Runs and checks all added jobs in order, then forgets them. Stops at
+    // and returns the first error.
+    int Run( void );
+
+private:
+    struct Job
+    {
+        size_t resultSize;
+        EnqueueFunc enqueue;
+        CheckFunc check;
+    };
+
+    struct Slot
+    {
+        cl_mem buffer;
+        void *result;
+        cl_event readDone;
+    };
+
+    int Issue( Slot &slot, const Job &job );
+
+    size_t maxResultSize;
+    std::vector<Slot> slots;
+    std::vector<Job> jobs;
+};
+
 #endif /* CL_UTILS_H */
 
 
@@ -35,6 +35,9 @@ extern cl_ulong getBufferCount(cl_device_id device_id, size_t vecSize, size_t ty
 // CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE
 #define kPageSize       4096
 
+// Number of kernel results kept in flight while earlier ones are checked
+#define kResultPipelineDepth 8
+
 extern int g_arrVecSizes[kVectorSizeCount+kStrangeVectorSizeCount];
 extern int g_arrVecAligns[kLargestVectorSize+1];
 
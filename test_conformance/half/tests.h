@@ -46,8 +46,9 @@ int test_roundTrip( cl_device_id deviceID, cl_context context, cl_command_queue
 
 typedef cl_ushort (*f2h)( float );
 typedef cl_ushort (*d2h)( double );
-int Test_vStoreHalf_private( cl_device_id device, f2h referenceFunc, d2h referenceDoubleFunc, const char *roundName );
-int Test_vStoreaHalf_private( cl_device_id device, f2h referenceFunc, d2h referenceDoubleFunc, const char *roundName );
+typedef void (*f2h_array)( cl_ushort *out, const float *in, size_t count );
+int Test_vStoreHalf_private( cl_device_id device, f2h referenceFunc, f2h_array referenceArrayFunc, d2h referenceDoubleFunc, const char *roundName );
+int Test_vStoreaHalf_private( cl_device_id device, f2h referenceFunc, f2h_array referenceArrayFunc, d2h referenceDoubleFunc, const char *roundName );
 
 #endif /* TESTS_H */
 
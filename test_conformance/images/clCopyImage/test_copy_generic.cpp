@@ -239,10 +239,11 @@ int test_copy_image_generic( cl_context context, cl_command_queue queue, image_d
     size_t scanlineSize = dstImageInfo->width * get_pixel_size( dstImageInfo->format );
     size_t rowPitch = dstImageInfo->rowPitch;
     size_t slicePitch = dstImageInfo->slicePitch;
+    size_t dst_width_lod = dstImageInfo->width;
     size_t dst_height_lod = dstImageInfo->height;
     if(gTestMipmaps)
     {
-        size_t dst_width_lod = (dstImageInfo->width >> dst_lod)?(dstImageInfo->width >> dst_lod) : 1;
+        dst_width_lod = (dstImageInfo->width >> dst_lod)?(dstImageInfo->width >> dst_lod) : 1;
         dst_height_lod = (dstImageInfo->height >> dst_lod)?(dstImageInfo->height >> dst_lod) : 1;
         scanlineSize = dst_width_lod * get_pixel_size(dstImageInfo->format);
         rowPitch = scanlineSize;
@@ -304,21 +305,17 @@ int test_copy_image_generic( cl_context context, cl_command_queue queue, image_d
     {
         for( size_t y = 0; y < secondDim; y++ )
         {
-            if( memcmp( sourcePtr, destPtr, scanlineSize ) != 0 )
+            // Find the first differing pixel
+            size_t where = compare_scanlines(
+                dstImageInfo->format, dst_width_lod, sourcePtr, destPtr);
+            if (where < dst_width_lod)
             {
-                // Find the first differing pixel
-                size_t pixel_size = get_pixel_size( dstImageInfo->format );
-                size_t where =
-                    compare_scanlines(dstImageInfo, sourcePtr, destPtr);
-
-                if (where < dstImageInfo->width)
-                {
-                    print_first_pixel_difference_error(
-                        where, sourcePtr + pixel_size * where,
-                        destPtr + pixel_size * where, dstImageInfo, y,
-                        dstImageInfo->depth);
-                    return -1;
-                }
+                size_t pixel_size = get_pixel_size(dstImageInfo->format);
+                print_first_pixel_difference_error(
+                    where, sourcePtr + pixel_size * where,
+                    destPtr + pixel_size * where, dstImageInfo, y,
+                    dstImageInfo->depth);
+                return -1;
             }
             sourcePtr += rowPitch;
             if((dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY || dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D))
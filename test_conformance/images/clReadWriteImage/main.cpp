@@ -16,7 +16,7 @@
 
 #include <stdio.h>
 #include <string.h>
-#include "../testBase.h"
+#include "test_common.h"
 #include "../harness/compat.h"
 
 bool gDebugTrace;
@@ -26,6 +26,7 @@ bool gTestMipmaps;
 cl_channel_type gChannelTypeToUse = (cl_channel_type)-1;
 cl_channel_order gChannelOrderToUse = (cl_channel_order)-1;
 bool            gEnablePitch = false;
+bool gUseHostPtr = false;
 
 static void printUsage( const char *execName );
 
@@ -83,6 +84,8 @@ int main(int argc, const char *argv[])
             gTestMaxImages = true;
         else if( strcmp( argv[i], "use_pitches" ) == 0 )
             gEnablePitch = true;
+        else if (strcmp(argv[i], "use_host_ptr") == 0)
+            gUseHostPtr = true;
         else if( strcmp( argv[i], "test_mipmaps") == 0 ) {
             gTestMipmaps = true;
             // Don't test pitches with mipmaps right now.
@@ -105,6 +108,12 @@ int main(int argc, const char *argv[])
 
     if( gTestSmallImages )
         log_info( "Note: Using small test images\n" );
+    if (gUseHostPtr && gTestMipmaps)
+    {
+        // Mipmapped images cannot be created with a host pointer.
+        log_info("Note: use_host_ptr is ignored when testing mipmaps\n");
+        gUseHostPtr = false;
+    }
 
     int ret = runTestHarnessWithCheck(
         argCount, argList, test_registry::getInstance().num_tests(),
@@ -128,6 +137,8 @@ static void printUsage( const char *execName )
     log_info( "\tmax_images - Runs every format through a set of size combinations with the max values, max values - 1, and max values / 128\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
     log_info( "\ttest_mipmaps - Test mipmapped images\n" );
+    log_info("\tuse_host_ptr - Backs images with page-aligned host memory "
+             "(CL_MEM_USE_HOST_PTR) and verifies through mapped pointers\n");
     log_info( "\trandomize - Uses random seed\n" );
     log_info( "\n" );
     log_info( "Test names:\n" );
@@ -0,0 +1,24 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef _clReadWriteImage_test_common_h
+#define _clReadWriteImage_test_common_h
+
+#include "../testBase.h"
+
+// Create the images with CL_MEM_USE_HOST_PTR and verify through a mapping
+extern bool gUseHostPtr;
+
+#endif // _clReadWriteImage_test_common_h
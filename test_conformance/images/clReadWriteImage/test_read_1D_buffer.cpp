@@ -13,7 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
-#include "../testBase.h"
+#include "test_common.h"
 #include <CL/cl.h>
 
 int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
@@ -22,13 +22,21 @@ int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
 {
     int error;
 
+    // Generate some data to test against. With a host pointer the buffer is
+    // created on this data, so the image does not need to be written.
+    BufferOwningPtr<char> imageValues;
+    if (gUseHostPtr)
+    {
+        if (generate_host_ptr_image_data(imageInfo, imageValues, d) == NULL)
+            return -1;
+    }
+    else
+        generate_random_image_data(imageInfo, imageValues, d);
+
+    // Declared after the data, so that it is released while the data is valid
     clMemWrapper image;
     clMemWrapper buffer;
 
-    // Generate some data to test against
-    BufferOwningPtr<char> imageValues;
-    generate_random_image_data(imageInfo, imageValues, d);
-
     if (gDebugTrace)
     {
         log_info(" - Creating 1D image %d...\n", (int)imageInfo->width);
@@ -36,7 +44,11 @@ int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
                  (unsigned long long)imageInfo->num_mip_levels);
     }
 
-    buffer = clCreateBuffer(context, flags, imageInfo->rowPitch, NULL, &error);
+    void *hostPtr = gUseHostPtr ? (char *)imageValues : NULL;
+
+    buffer = clCreateBuffer(context,
+                            gUseHostPtr ? flags | CL_MEM_USE_HOST_PTR : flags,
+                            imageInfo->rowPitch, hostPtr, &error);
     if (error != CL_SUCCESS)
     {
         log_error("ERROR: Unable to create buffer for 1D image buffer of size "
@@ -59,18 +71,23 @@ int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
     size_t region[3] = { imageInfo->width, 1, 1 };
     size_t fullImageSize = imageInfo->rowPitch;
 
-    BufferOwningPtr<char> resultValues(malloc(fullImageSize));
+    // With a host pointer the results are verified through a mapping instead
+    BufferOwningPtr<char> resultValues(gUseHostPtr ? NULL
+                                                   : malloc(fullImageSize));
     size_t imgValMipLevelOffset = 0;
 
-    error = clEnqueueWriteImage(queue, image, CL_FALSE, origin, region,
-                                (gEnablePitch ? imageInfo->rowPitch : 0), 0,
-                                (char *)imageValues + imgValMipLevelOffset, 0,
-                                NULL, NULL);
-    if (error != CL_SUCCESS)
+    if (!gUseHostPtr)
     {
-        log_error("ERROR: Unable to write to 1D image of size %d \n",
-                  (int)imageInfo->width);
-        return -1;
+        error = clEnqueueWriteImage(
+            queue, image, CL_FALSE, origin, region,
+            (gEnablePitch ? imageInfo->rowPitch : 0), 0,
+            (char *)imageValues + imgValMipLevelOffset, 0, NULL, NULL);
+        if (error != CL_SUCCESS)
+        {
+            log_error("ERROR: Unable to write to 1D image of size %d \n",
+                      (int)imageInfo->width);
+            return -1;
+        }
     }
 
     // To verify, we just read the results right back and see whether they
@@ -83,19 +100,36 @@ int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
     // Note: we read back without any pitch, to verify pitch actually WORKED
     size_t scanlineSize = imageInfo->width * get_pixel_size(imageInfo->format);
     size_t imageSize = scanlineSize;
-    memset(resultValues, 0xff, imageSize);
+    char *mappedPtr = NULL;
+
+    if (gUseHostPtr)
+    {
+        if (gDebugTrace) log_info(" - Mapping results...\n");
 
-    if (gDebugTrace) log_info(" - Reading results...\n");
+        size_t mappedRowPitch;
+        mappedPtr = (char *)clEnqueueMapImage(
+            queue, image, CL_TRUE, CL_MAP_READ, origin, region,
+            &mappedRowPitch, NULL, 0, NULL, NULL, &error);
+        test_error(error, "Unable to map image values");
+    }
+    else
+    {
+        memset(resultValues, 0xff, imageSize);
 
-    error = clEnqueueReadImage(queue, image, CL_TRUE, origin, region, 0, 0,
-                               resultValues, 0, NULL, NULL);
-    test_error(error, "Unable to read image values");
+        if (gDebugTrace) log_info(" - Reading results...\n");
+
+        error = clEnqueueReadImage(queue, image, CL_TRUE, origin, region, 0,
+                                   0, resultValues, 0, NULL, NULL);
+        test_error(error, "Unable to read image values");
+    }
 
     // Verify scanline by scanline, since the pitches are different
     char *sourcePtr = (char *)imageValues + imgValMipLevelOffset;
-    char *destPtr = resultValues;
+    char *destPtr = gUseHostPtr ? mappedPtr : (char *)resultValues;
 
-    if (memcmp(sourcePtr, destPtr, scanlineSize) != 0)
+    if (compare_scanlines_exact(imageInfo->format, imageInfo->width,
+                                sourcePtr, destPtr)
+        < imageInfo->width)
     {
         log_error("ERROR: Scanline did not verify for image size %d pitch "
                   "%d (extra %d bytes)\n",
@@ -141,8 +175,18 @@ int test_read_image_1D_buffer(cl_context context, cl_command_queue queue,
         {
             log_error("      Unable to determine offset\n");
         }
+        if (mappedPtr != NULL)
+            clEnqueueUnmapMemObject(queue, image, mappedPtr, 0, NULL,
+                                    NULL);
         return -1;
     }
+
+    if (mappedPtr != NULL)
+    {
+        error = clEnqueueUnmapMemObject(queue, image, mappedPtr, 0, NULL,
+                                        NULL);
+        test_error(error, "Unable to unmap image values");
+    }
     imgValMipLevelOffset +=
         imageInfo->width * get_pixel_size(imageInfo->format);
     return 0;
@@ -13,7 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
-#include "../testBase.h"
+#include "test_common.h"
 
 int test_read_image_2D_array(cl_context context, cl_command_queue queue,
                              image_descriptor *imageInfo, MTdata d,
@@ -21,11 +21,19 @@ int test_read_image_2D_array(cl_context context, cl_command_queue queue,
 {
     int error;
 
-    clMemWrapper image;
-
-    // Create some data to test against
+    // Create some data to test against. With a host pointer the image is
+    // created on this data, so it does not need to be written.
     BufferOwningPtr<char> imageValues;
-    generate_random_image_data( imageInfo, imageValues, d );
+    if (gUseHostPtr)
+    {
+        if (generate_host_ptr_image_data(imageInfo, imageValues, d) == NULL)
+            return -1;
+    }
+    else
+        generate_random_image_data(imageInfo, imageValues, d);
+
+    // Declared after the data, so that it is released while the data is valid
+    clMemWrapper image;
 
     if( gDebugTrace )
     {
@@ -37,9 +45,13 @@ int test_read_image_2D_array(cl_context context, cl_command_queue queue,
     // Construct testing sources
     if(!gTestMipmaps)
     {
-        image = create_image_2d_array(context, flags, imageInfo->format,
-                                      imageInfo->width, imageInfo->height,
-                                      imageInfo->arraySize, 0, 0, NULL, &error);
+        void *hostPtr = gUseHostPtr ? (char *)imageValues : NULL;
+
+        image = create_image_2d_array(
+            context, gUseHostPtr ? flags | CL_MEM_USE_HOST_PTR : flags,
+            imageInfo->format, imageInfo->width, imageInfo->height,
+            imageInfo->arraySize, gUseHostPtr ? imageInfo->rowPitch : 0,
+            gUseHostPtr ? imageInfo->slicePitch : 0, hostPtr, &error);
         if( image == NULL )
         {
             log_error( "ERROR: Unable to create 2D image array of size %d x %d x %d (%s)", (int)imageInfo->width, (int)imageInfo->height, (int)imageInfo->arraySize, IGetErrorString( error ) );
@@ -78,7 +90,9 @@ int test_read_image_2D_array(cl_context context, cl_command_queue queue,
     {
         fullImageSize = imageInfo->arraySize * imageInfo->slicePitch;
     }
-    BufferOwningPtr<char> resultValues(malloc(fullImageSize));
+    // With a host pointer the results are verified through a mapping instead
+    BufferOwningPtr<char> resultValues(gUseHostPtr ? NULL
+                                                   : malloc(fullImageSize));
     size_t imgValMipLevelOffset = 0;
 
     for(size_t lod = 0; (gTestMipmaps && lod < imageInfo->num_mip_levels) || (!gTestMipmaps && lod < 1); lod++)
@@ -98,12 +112,21 @@ int test_read_image_2D_array(cl_context context, cl_command_queue queue,
             log_info(" - Working at mipLevel :%llu\n", (unsigned long long)lod);
         }
 
-        error = clEnqueueWriteImage(queue, image, CL_FALSE,
-                                    origin, region, ( gEnablePitch ? row_pitch_lod : 0 ), ( gEnablePitch ? slice_pitch_lod : 0 ),
-                                    (char*)imageValues + imgValMipLevelOffset, 0, NULL, NULL);
-        if (error != CL_SUCCESS) {
-            log_error( "ERROR: Unable to write to 2D image array of size %d x %d x %d\n", (int)width_lod, (int)height_lod, (int)imageInfo->arraySize );
-            return -1;
+        if (!gUseHostPtr)
+        {
+            error = clEnqueueWriteImage(
+                queue, image, CL_FALSE, origin, region,
+                (gEnablePitch ? row_pitch_lod : 0),
+                (gEnablePitch ? slice_pitch_lod : 0),
+                (char *)imageValues + imgValMipLevelOffset, 0, NULL, NULL);
+            if (error != CL_SUCCESS)
+            {
+                log_error("ERROR: Unable to write to 2D image array of size %d "
+                          "x %d x %d\n",
+                          (int)width_lod, (int)height_lod,
+                          (int)imageInfo->arraySize);
+                return -1;
+            }
         }
 
         // To verify, we just read the results right back and see whether they match the input
@@ -114,32 +137,60 @@ int test_read_image_2D_array(cl_context context, cl_command_queue queue,
         size_t scanlineSize = width_lod * get_pixel_size( imageInfo->format );
         size_t pageSize = scanlineSize * height_lod;
         size_t imageSize = pageSize * imageInfo->arraySize;
-        memset( resultValues, 0xff, imageSize );
+        size_t resultRowPitch = scanlineSize;
+        size_t resultSlicePitch = pageSize;
+        char *mappedPtr = NULL;
 
-        if( gDebugTrace )
-            log_info( " - Reading results...\n" );
+        if (gUseHostPtr)
+        {
+            if (gDebugTrace) log_info(" - Mapping results...\n");
+
+            mappedPtr = (char *)clEnqueueMapImage(
+                queue, image, CL_TRUE, CL_MAP_READ, origin, region,
+                &resultRowPitch, &resultSlicePitch, 0, NULL, NULL, &error);
+            test_error(error, "Unable to map image values");
+        }
+        else
+        {
+            memset(resultValues, 0xff, imageSize);
+
+            if (gDebugTrace) log_info(" - Reading results...\n");
 
-        error = clEnqueueReadImage( queue, image, CL_TRUE, origin, region, 0, 0, resultValues, 0, NULL, NULL );
-        test_error( error, "Unable to read image values" );
+            error = clEnqueueReadImage(queue, image, CL_TRUE, origin, region,
+                                       0, 0, resultValues, 0, NULL, NULL);
+            test_error(error, "Unable to read image values");
+        }
 
         // Verify scanline by scanline, since the pitches are different
         char *sourcePtr = (char *)imageValues + imgValMipLevelOffset;
-        char *destPtr = resultValues;
+        char *destPtr = gUseHostPtr ? mappedPtr : (char *)resultValues;
 
         for( size_t z = 0; z < imageInfo->arraySize; z++ )
         {
             for( size_t y = 0; y < height_lod; y++ )
             {
-                if( memcmp( sourcePtr, destPtr, scanlineSize ) != 0 )
+                if (compare_scanlines_exact(imageInfo->format, width_lod,
+                                            sourcePtr, destPtr)
+                    < width_lod)
                 {
                     log_error( "ERROR: Scanline %d,%d did not verify for image size %d,%d,%d pitch %d,%d\n", (int)y, (int)z, (int)width_lod, (int)height_lod, (int)imageInfo->arraySize, (int)row_pitch_lod, (int)slice_pitch_lod );
+                    if (mappedPtr != NULL)
+                        clEnqueueUnmapMemObject(queue, image, mappedPtr, 0,
+                                                NULL, NULL);
                     return -1;
                 }
                 sourcePtr += row_pitch_lod;
-                destPtr += scanlineSize;
+                destPtr += resultRowPitch;
             }
             sourcePtr += slice_pitch_lod - ( row_pitch_lod * height_lod );
-            destPtr += pageSize - scanlineSize * height_lod;
+            destPtr += resultSlicePitch - resultRowPitch * height_lod;
+        }
+
+        if (mappedPtr != NULL)
+        {
+            error = clEnqueueUnmapMemObject(queue, image, mappedPtr, 0, NULL,
+                                            NULL);
+            test_error(error, "Unable to unmap image values");
         }
         imgValMipLevelOffset += width_lod * height_lod * imageInfo->arraySize * get_pixel_size( imageInfo->format );
     }
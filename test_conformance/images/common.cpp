@@ -129,15 +129,8 @@ int get_format_list(cl_context context, cl_mem_object_type imageType,
                     std::vector<cl_image_format> &outFormatList,
                     cl_mem_flags flags)
 {
-    cl_uint formatCount;
-    int error = clGetSupportedImageFormats(context, flags, imageType, 0, NULL,
-                                           &formatCount);
-    test_error(error, "Unable to get count of supported image formats");
-
-    outFormatList.resize(formatCount);
-
-    error = clGetSupportedImageFormats(context, flags, imageType, formatCount,
-                                       outFormatList.data(), NULL);
+    int error =
+        get_supported_image_formats(context, flags, imageType, outFormatList);
     test_error(error, "Unable to get list of supported image formats");
     return 0;
 }
@@ -31,6 +31,7 @@ __thread fpu_control_t fpu_control = 0;
 bool gDebugTrace;
 bool gExtraValidateInfo;
 bool gDisableOffsets;
+bool gBoundaryCoords;
 bool gTestSmallImages;
 bool gTestMaxImages;
 bool gTestImage2DFromBuffer;
@@ -392,6 +393,8 @@ int main(int argc, const char *argv[])
 
         else if( strcmp( argv[i], "no_offsets" ) == 0 )
             gDisableOffsets = true;
+        else if (strcmp(argv[i], "boundary_coords") == 0)
+            gBoundaryCoords = true;
         else if( strcmp( argv[i], "small_images" ) == 0 )
             gTestSmallImages = true;
         else if( strcmp( argv[i], "max_images" ) == 0 )
@@ -531,6 +534,9 @@ static void printUsage( const char *execName )
     log_info( "\t\trounding - Runs every format through a single image filled with every possible value for that image format, to verify rounding works properly\n" );
     log_info( "\n" );
     log_info( "\tno_offsets - Disables offsets when testing reads (can be good for diagnosing address repeating/clamping problems)\n" );
+    log_info("\tboundary_coords - Replaces the offset passes with reads "
+             "within a few ulps of texel edges, texel centers, wrap points "
+             "and the texel edges of neighbouring mip levels\n");
     log_info( "\tdebug_trace - Enables additional debug info logging\n" );
     log_info( "\textra_validate - Enables additional validation failure debug information\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
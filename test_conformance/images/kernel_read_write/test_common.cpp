@@ -75,6 +75,66 @@ bool get_image_dimensions(image_descriptor *imageInfo, size_t &width,
     return get_image_dimensions(imageInfo, width, height, depth, ignoreMe);
 }
 
+float get_boundary_coord(int x, size_t size, bool normalized,
+                         bool insideImage, MTdata d)
+{
+    float boundary;
+    if (insideImage || genrand_bool(d))
+    {
+        // A texel edge next to the texel itself
+        boundary = (float)(x + random_in_range(0, 1, d));
+    }
+    else
+    {
+        // An image edge or a repeat/mirrored repeat wrap point
+        boundary = (float)((long)size * random_in_range(-2, 2, d));
+    }
+    // Linear filtering changes texels at the texel centers
+    if (genrand_bool(d)) boundary += 0.5f;
+
+    // Normalize before stepping, so that the steps are not rounded away
+    if (normalized) boundary /= (float)size;
+    for (int steps = random_in_range(-2, 2, d); steps != 0;
+         steps += (steps < 0) ? 1 : -1)
+        boundary = nextafterf(boundary, (steps < 0) ? -INFINITY : INFINITY);
+
+    if (insideImage)
+    {
+        float last = (float)(size - 1);
+        if (normalized) last /= (float)size;
+        boundary = CLAMP(boundary, 0.0f, last);
+    }
+    return boundary;
+}
+
+float get_lod_boundary_coord(int x, size_t baseSize, int lod, int numLevels,
+                             bool normalized, bool insideImage, MTdata d)
+{
+    size_t size = (baseSize >> lod) ? (baseSize >> lod) : 1;
+    int level = lod;
+    if ((genrand_int32(d) & 3) == 0)
+    {
+        if (lod + 1 < numLevels && (lod == 0 || genrand_bool(d)))
+            level = lod + 1;
+        else if (lod > 0)
+            level = lod - 1;
+    }
+    if (level == lod)
+        return get_boundary_coord(x, size, normalized, insideImage, d);
+
+    size_t levelSize = (baseSize >> level) ? (baseSize >> level) : 1;
+    float boundary = get_boundary_coord((int)((size_t)x * levelSize / size),
+                                        levelSize, true, false, d);
+    if (!normalized) boundary *= (float)size;
+    if (insideImage)
+    {
+        float last = (float)(size - 1);
+        if (normalized) last /= (float)size;
+        boundary = CLAMP(boundary, 0.0f, last);
+    }
+    return boundary;
+}
+
 static bool InitFloatCoordsCommon(image_descriptor *imageInfo,
                                   image_sampler_data *imageSampler,
                                   float *xOffsets, float *yOffsets,
@@ -214,6 +274,63 @@ static bool InitFloatCoordsCommon(image_descriptor *imageInfo,
                 }
             }
         }
+
+        if (gBoundaryCoords && !gDisableOffsets)
+        {
+            // Replace the coordinates with ones next to a boundary, in the
+            // space the kernel samples in. Mipmapped axes include the
+            // boundaries of the neighbouring levels.
+            bool normalized = normalized_coords || gTestMipmaps;
+            bool inside = imageSampler->addressing_mode == CL_ADDRESS_NONE;
+            bool mipY = gTestMipmaps
+                && imageInfo->type != CL_MEM_OBJECT_IMAGE1D_ARRAY;
+            bool mipZ = gTestMipmaps
+                && imageInfo->type != CL_MEM_OBJECT_IMAGE2D_ARRAY;
+            int levels = gTestMipmaps ? (int)imageInfo->num_mip_levels : 1;
+            size_t width_lod = width_loop, height_lod = height_loop,
+                   depth_lod = depth_loop;
+            if (gTestMipmaps && lod > 0)
+            {
+                width_lod = (width_loop >> lod) ? (width_loop >> lod) : 1;
+                if (mipY)
+                    height_lod =
+                        (height_loop >> lod) ? (height_loop >> lod) : 1;
+                if (mipZ)
+                    depth_lod = (depth_loop >> lod) ? (depth_loop >> lod) : 1;
+            }
+
+            i = 0;
+            for (size_t z = 0; z < depth_lod; z++)
+            {
+                for (size_t y = 0; y < height_lod; y++)
+                {
+                    for (size_t x = 0; x < width_lod; x++, i++)
+                    {
+                        xOffsets[i] = get_lod_boundary_coord(
+                            (int)x, width_loop, gTestMipmaps ? lod : 0,
+                            levels, normalized, inside, d);
+                        yOffsets[i] = mipY
+                            ? get_lod_boundary_coord((int)y, height_loop, lod,
+                                                     levels, true, inside, d)
+                            : get_boundary_coord(
+                                (int)y, height_lod,
+                                normalized
+                                    && imageInfo->type
+                                        != CL_MEM_OBJECT_IMAGE1D_ARRAY,
+                                inside, d);
+                        zOffsets[i] = mipZ
+                            ? get_lod_boundary_coord((int)z, depth_loop, lod,
+                                                     levels, true, inside, d)
+                            : get_boundary_coord(
+                                (int)z, depth_lod,
+                                normalized
+                                    && imageInfo->type
+                                        != CL_MEM_OBJECT_IMAGE2D_ARRAY,
+                                inside, d);
+                    }
+                }
+            }
+        }
     }
     return error;
 }
@@ -571,6 +688,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
     int numTries = MAX_TRIES, numClamped = MAX_CLAMPED;
     int loopCount = 2 * float_offset_count;
     if (!useFloatCoords) loopCount = 1;
+    else if (gBoundaryCoords && !gDisableOffsets)
+        loopCount = kBoundaryCoordPasses;
     if (gTestMaxImages)
     {
         loopCount = 1;
@@ -595,6 +714,11 @@ int test_read_image(cl_context context, cl_command_queue queue,
         }
     }
 
+    // Precompute the reference levels once. Decoding to float RGBA takes 4 to
+    // 12 times the space of 8 or 16 bit data, so skip it for max sized images.
+    MipmapReference mipmapReference(imageValues, imageInfo,
+                                    outputType == kFloat && !gTestMaxImages);
+
     int nextLevelOffset = 0;
     size_t width_lod = width_size, height_lod = height_size,
            depth_lod = depth_size;
@@ -675,6 +799,9 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
             // Validate results element by element
             char *imagePtr = (char *)imageValues + nextLevelOffset;
+            char *levelPtr = mipmapReference.GetFloatLevelData(lod);
+            image_descriptor *levelInfo =
+                mipmapReference.GetFloatLevelInfo(lod);
             if (((imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
                  && (imageInfo->format->image_channel_order == CL_DEPTH))
                 && (outputType == kFloat))
@@ -731,13 +858,13 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                         int hasDenormals = 0;
                                         FloatPixel maxPixel =
                                             sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
+                                                levelPtr, levelInfo,
                                                 xOffsetValues[j],
                                                 yOffsetValues[j],
                                                 zOffsetValues[j], norm_offset_x,
                                                 norm_offset_y, norm_offset_z,
                                                 imageSampler, expected, 0,
-                                                &hasDenormals, lod);
+                                                &hasDenormals);
 
                                         float err1 = ABS_ERROR(resultPtr[0],
                                                                expected[0]);
@@ -763,7 +890,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                                 maxPixel =
                                                     sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
+                                                        levelPtr, levelInfo,
                                                         xOffsetValues[j],
                                                         yOffsetValues[j],
                                                         zOffsetValues[j],
@@ -771,7 +898,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                         norm_offset_y,
                                                         norm_offset_z,
                                                         imageSampler, expected,
-                                                        0, NULL, lod);
+                                                        0, NULL);
 
                                                 err1 = ABS_ERROR(resultPtr[0],
                                                                  expected[0]);
@@ -813,15 +940,14 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                             int hasDenormals = 0;
                                             FloatPixel maxPixel =
                                                 sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
+                                                    levelPtr, levelInfo,
                                                     xOffsetValues[j],
                                                     yOffsetValues[j],
                                                     zOffsetValues[j],
                                                     norm_offset_x,
                                                     norm_offset_y,
                                                     norm_offset_z, imageSampler,
-                                                    expected, 0, &hasDenormals,
-                                                    lod);
+                                                    expected, 0, &hasDenormals);
 
                                             float err1 = ABS_ERROR(resultPtr[0],
                                                                    expected[0]);
@@ -839,13 +965,12 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                                     maxPixel =
                                                         sample_image_pixel_float(
-                                                            imagePtr, imageInfo,
+                                                            levelPtr, levelInfo,
                                                             xOffsetValues[j],
                                                             yOffsetValues[j],
                                                             zOffsetValues[j],
                                                             imageSampler,
-                                                            expected, 0, NULL,
-                                                            lod);
+                                                            expected, 0, NULL);
 
                                                     err1 =
                                                         ABS_ERROR(resultPtr[0],
@@ -980,7 +1105,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                         int hasDenormals = 0;
                                         FloatPixel maxPixel =
                                             sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
+                                                levelPtr, levelInfo,
                                                 xOffsetValues[j],
                                                 (num_dimensions > 1)
                                                     ? yOffsetValues[j]
@@ -994,7 +1119,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                 image_type_3D ? norm_offset_z
                                                               : 0.0f,
                                                 imageSampler, expected, 0,
-                                                &hasDenormals, lod);
+                                                &hasDenormals);
 
                                         float err1 =
                                             ABS_ERROR(sRGBmap(resultPtr[0]),
@@ -1046,7 +1171,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                                 maxPixel =
                                                     sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
+                                                        levelPtr, levelInfo,
                                                         xOffsetValues[j],
                                                         (num_dimensions > 1)
                                                             ? yOffsetValues[j]
@@ -1062,7 +1187,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                             ? norm_offset_z
                                                             : 0.0f,
                                                         imageSampler, expected,
-                                                        0, NULL, lod);
+                                                        0, NULL);
 
                                                 err1 = ABS_ERROR(
                                                     sRGBmap(resultPtr[0]),
@@ -1130,7 +1255,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                             int hasDenormals = 0;
                                             FloatPixel maxPixel =
                                                 sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
+                                                    levelPtr, levelInfo,
                                                     xOffsetValues[j],
                                                     (num_dimensions > 1)
                                                         ? yOffsetValues[j]
@@ -1146,7 +1271,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                         ? norm_offset_z
                                                         : 0.0f,
                                                     imageSampler, expected, 0,
-                                                    &hasDenormals, lod);
+                                                    &hasDenormals);
 
                                             float err1 =
                                                 ABS_ERROR(sRGBmap(resultPtr[0]),
@@ -1177,7 +1302,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                                     maxPixel =
                                                         sample_image_pixel_float(
-                                                            imagePtr, imageInfo,
+                                                            levelPtr, levelInfo,
                                                             xOffsetValues[j],
                                                             (num_dimensions > 1)
                                                                 ? yOffsetValues
@@ -1188,8 +1313,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                                     [j]
                                                                 : 0.0f,
                                                             imageSampler,
-                                                            expected, 0, NULL,
-                                                            lod);
+                                                            expected, 0, NULL);
 
                                                     err1 = ABS_ERROR(
                                                         sRGBmap(resultPtr[0]),
@@ -1358,7 +1482,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                         int hasDenormals = 0;
                                         FloatPixel maxPixel =
                                             sample_image_pixel_float_offset(
-                                                imagePtr, imageInfo,
+                                                levelPtr, levelInfo,
                                                 xOffsetValues[j],
                                                 (num_dimensions > 1)
                                                     ? yOffsetValues[j]
@@ -1372,7 +1496,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                 image_type_3D ? norm_offset_z
                                                               : 0.0f,
                                                 imageSampler, expected, 0,
-                                                &hasDenormals, lod);
+                                                &hasDenormals);
 
                                         float err1 = ABS_ERROR(resultPtr[0],
                                                                expected[0]);
@@ -1431,7 +1555,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                                 maxPixel =
                                                     sample_image_pixel_float_offset(
-                                                        imagePtr, imageInfo,
+                                                        levelPtr, levelInfo,
                                                         xOffsetValues[j],
                                                         (num_dimensions > 1)
                                                             ? yOffsetValues[j]
@@ -1447,7 +1571,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                             ? norm_offset_z
                                                             : 0.0f,
                                                         imageSampler, expected,
-                                                        0, NULL, lod);
+                                                        0, NULL);
 
                                                 err1 = ABS_ERROR(resultPtr[0],
                                                                  expected[0]);
@@ -1512,7 +1636,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                             int hasDenormals = 0;
                                             FloatPixel maxPixel =
                                                 sample_image_pixel_float_offset(
-                                                    imagePtr, imageInfo,
+                                                    levelPtr, levelInfo,
                                                     xOffsetValues[j],
                                                     (num_dimensions > 1)
                                                         ? yOffsetValues[j]
@@ -1528,7 +1652,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                         ? norm_offset_z
                                                         : 0.0f,
                                                     imageSampler, expected, 0,
-                                                    &hasDenormals, lod);
+                                                    &hasDenormals);
 
                                             float err1 = ABS_ERROR(resultPtr[0],
                                                                    expected[0]);
@@ -1567,7 +1691,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
                                                     maxPixel =
                                                         sample_image_pixel_float(
-                                                            imagePtr, imageInfo,
+                                                            levelPtr, levelInfo,
                                                             xOffsetValues[j],
                                                             (num_dimensions > 1)
                                                                 ? yOffsetValues
@@ -1578,8 +1702,7 @@ int test_read_image(cl_context context, cl_command_queue queue,
                                                                     [j]
                                                                 : 0.0f,
                                                             imageSampler,
-                                                            expected, 0, NULL,
-                                                            lod);
+                                                            expected, 0, NULL);
 
                                                     err1 =
                                                         ABS_ERROR(resultPtr[0],
@@ -2126,13 +2249,14 @@ int test_read_image(cl_context context, cl_command_queue queue,
 
 void filter_undefined_bits(image_descriptor *imageInfo, char *resultPtr)
 {
-    // mask off the top bit (bit 15) if the image format is (CL_UNORM_SHORT_555,
-    // CL_RGB). (Note: OpenCL says: the top bit is undefined meaning it can be
-    // either 0 or 1.)
-    if (imageInfo->format->image_channel_data_type == CL_UNORM_SHORT_555)
+    // mask off the bits that OpenCL leaves undefined for the format, e.g. the
+    // top bit (bit 15) of (CL_UNORM_SHORT_555, CL_RGB). (Note: OpenCL says:
+    // the top bit is undefined meaning it can be either 0 or 1.)
+    cl_uchar mask[16];
+    if (get_undefined_bits_mask(imageInfo->format, mask))
     {
-        cl_ushort *temp = (cl_ushort *)resultPtr;
-        temp[0] &= 0x7fff;
+        size_t pixel_size = get_pixel_size(imageInfo->format);
+        for (size_t i = 0; i < pixel_size; i++) resultPtr[i] &= mask[i];
     }
 }
 
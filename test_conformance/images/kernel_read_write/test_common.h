@@ -30,6 +30,7 @@ extern void read_image_pixel_float(void *imageData, image_descriptor *imageInfo,
 
 extern bool gExtraValidateInfo;
 extern bool gDisableOffsets;
+extern bool gBoundaryCoords;
 extern bool gUseKernelSamplers;
 extern cl_mem_flags gMemFlagsToUse;
 extern int gtestTypesToRun;
@@ -45,6 +46,24 @@ extern int test_read_image(cl_context context, cl_command_queue queue,
 extern bool get_image_dimensions(image_descriptor *imageInfo, size_t &width,
                                  size_t &height, size_t &depth);
 
+// Returns a coordinate for texel x of an axis of the given size within a few
+// ulps of an addressing or filtering boundary. With insideImage set the
+// coordinate is kept within the image, for CL_ADDRESS_NONE.
+extern float get_boundary_coord(int x, size_t size, bool normalized,
+                                bool insideImage, MTdata d);
+
+// Like get_boundary_coord, for texel x of level lod of a mipmapped axis with
+// baseSize texels at level 0. A quarter of the coordinates are boundaries of
+// the next or previous level instead, which only line up with the boundaries
+// of this level when no level size was rounded down.
+extern float get_lod_boundary_coord(int x, size_t baseSize, int lod,
+                                    int numLevels, bool normalized,
+                                    bool insideImage, MTdata d);
+
+// With boundary_coords every coordinate is a boundary one, and these passes
+// replace the passes over the fixed fractional offsets.
+const int kBoundaryCoordPasses = 2;
+
 template <class T>
 int determine_validation_error_offset(
     void *imagePtr, image_descriptor *imageInfo,
@@ -345,11 +345,38 @@ static void InitFloatCoords( image_descriptor *imageInfo, image_sampler_data *im
             }
         }
     }
+
+    if (gBoundaryCoords && !gDisableOffsets)
+    {
+        // Replace the coordinates with ones next to a boundary, in the space
+        // the kernel samples in. Mipmapped images include the boundaries of
+        // the neighbouring levels.
+        bool inside = imageSampler->addressing_mode == CL_ADDRESS_NONE;
+        int levels = gTestMipmaps ? (int)imageInfo->num_mip_levels : 1;
+        int level = gTestMipmaps ? (int)lod : 0;
+        i = 0;
+        for (size_t y = 0; y < height_lod; y++)
+        {
+            for (size_t x = 0; x < width_lod; x++, i++)
+            {
+                xOffsets[i] = get_lod_boundary_coord(
+                    (int)x, imageInfo->width, level, levels,
+                    normalized_coords, inside, d);
+                yOffsets[i] = get_lod_boundary_coord(
+                    (int)y, imageInfo->height, level, levels,
+                    normalized_coords, inside, d);
+            }
+        }
+    }
 }
 
 int validate_image_2D_depth_results(void *imageValues, void *resultValues, double formatAbsoluteError, float *xOffsetValues, float *yOffsetValues,
-                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr)
+                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr,
+                                                        MipmapReference &mipmapReference)
 {
+    char *levelPtr = mipmapReference.GetFloatLevelData(lod);
+    image_descriptor *levelInfo = mipmapReference.GetFloatLevelInfo(lod);
+
     // Validate results element by element
     size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
     size_t height_lod = (imageInfo->height >> lod ) ?(imageInfo->height >> lod ) : 1;
@@ -389,7 +416,7 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
                         // Try sampling the pixel, without flushing denormals.
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
-                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                        maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
                                                                     imageSampler, expected, 0, &containsDenormals );
 
@@ -409,7 +436,7 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
                                 // max error needs to be adjusted
                                 maxErr1 += 4 * FLT_MIN;
 
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                              xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                              imageSampler, expected, 0, NULL );
 
@@ -445,7 +472,7 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
 
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                            maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                                     imageSampler, expected, 0, &containsDenormals );
 
@@ -461,7 +488,7 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
                                 {
                                     maxErr1 += 4 * FLT_MIN;
 
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                    maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                                  xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                                  imageSampler, expected, 0, NULL );
 
@@ -508,8 +535,12 @@ int validate_image_2D_depth_results(void *imageValues, void *resultValues, doubl
 }
 
 int validate_image_2D_results(void *imageValues, void *resultValues, double formatAbsoluteError, float *xOffsetValues, float *yOffsetValues,
-                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr)
+                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr,
+                                                        MipmapReference &mipmapReference)
 {
+    char *levelPtr = mipmapReference.GetFloatLevelData(lod);
+    image_descriptor *levelInfo = mipmapReference.GetFloatLevelInfo(lod);
+
     // Validate results element by element
     size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
     size_t height_lod = (imageInfo->height >> lod ) ?(imageInfo->height >> lod ) : 1;
@@ -550,12 +581,7 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                         // Try sampling the pixel, without flushing denormals.
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
-                        if ( gTestMipmaps )
-                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals, lod );
-                        else
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                        maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
                                                                         imageSampler, expected, 0, &containsDenormals );
 
@@ -591,12 +617,7 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                                 maxErr3 += 4 * FLT_MIN;
                                 maxErr4 += 4 * FLT_MIN;
 
-                                if(gTestMipmaps)
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL,lod );
-                                else
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                                  xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                                  imageSampler, expected, 0, NULL );
 
@@ -635,12 +656,7 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
 
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
-                            if(gTestMipmaps)
-                                maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals, lod );
-                            else
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                            maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                                         imageSampler, expected, 0, &containsDenormals );
 
@@ -669,12 +685,7 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                                     maxErr3 += 4 * FLT_MIN;
                                     maxErr4 += 4 * FLT_MIN;
 
-                                    if(gTestMipmaps)
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL, lod );
-                                    else
-                                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                    maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                                      imageSampler, expected, 0, NULL );
 
@@ -932,8 +943,12 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
 }
 
 int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double formatAbsoluteError, float *xOffsetValues, float *yOffsetValues,
-                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr)
+                                                        ExplicitType outputType, int &numTries, int &numClamped, image_sampler_data *imageSampler, image_descriptor *imageInfo, size_t lod, char *imagePtr,
+                                                        MipmapReference &mipmapReference)
 {
+    char *levelPtr = mipmapReference.GetFloatLevelData(lod);
+    image_descriptor *levelInfo = mipmapReference.GetFloatLevelInfo(lod);
+
     // Validate results element by element
     size_t width_lod = (imageInfo->width >> lod ) ?(imageInfo->width >> lod ) : 1;
     size_t height_lod = (imageInfo->height >> lod ) ?(imageInfo->height >> lod ) : 1;
@@ -974,12 +989,7 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
                         // Try sampling the pixel, without flushing denormals.
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
-                        if ( gTestMipmaps )
-                            maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                        imageSampler, expected, 0, &containsDenormals, lod );
-                        else
-                            maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                        maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
                                                                         imageSampler, expected, 0, &containsDenormals );
                         float err1 = ABS_ERROR(sRGBmap(resultPtr[0]),
@@ -1002,12 +1012,7 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
                                 // max error needs to be adjusted
                                 maxErr += 4 * FLT_MIN;
 
-                                if(gTestMipmaps)
-                                    maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                 xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                 imageSampler, expected, 0, NULL,lod );
-                                else
-                                    maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                                  xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                                  imageSampler, expected, 0, NULL );
 
@@ -1049,12 +1054,7 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
 
                             int containsDenormals = 0;
                             FloatPixel maxPixel;
-                            if(gTestMipmaps)
-                                maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                        xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                        imageSampler, expected, 0, &containsDenormals, lod );
-                            else
-                                maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                            maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                                         imageSampler, expected, 0, &containsDenormals );
 
@@ -1076,12 +1076,7 @@ int validate_image_2D_sRGB_results(void *imageValues, void *resultValues, double
                                     // If implementation decide to flush subnormals to zero,
                                     // max error needs to be adjusted
                                     maxErr += 4 * FLT_MIN;
-                                    if(gTestMipmaps)
-                                        maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
-                                                                                     xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
-                                                                                     imageSampler, expected, 0, NULL, lod );
-                                    else
-                                        maxPixel = sample_image_pixel_float_offset( imageValues, imageInfo,
+                                    maxPixel = sample_image_pixel_float_offset( levelPtr, levelInfo,
                                                                                      xOffsetValues[ j ], yOffsetValues[ j ], 0.f, norm_offset_x, norm_offset_y, 0.0f,
                                                                                      imageSampler, expected, 0, NULL );
 
@@ -1456,6 +1451,8 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
     int loopCount = 2 * float_offset_count;
     if( ! useFloatCoords )
         loopCount = 1;
+    else if (gBoundaryCoords && !gDisableOffsets)
+        loopCount = kBoundaryCoordPasses;
     if (gTestMaxImages) {
         loopCount = 1;
       log_info("Testing each size only once with pixel offsets of %g for max sized images.\n", float_offsets[0]);
@@ -1477,6 +1474,11 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
         }
     }
 
+    // Precompute the reference levels once. Decoding to float RGBA takes 4 to
+    // 12 times the space of 8 or 16 bit data, so skip it for max sized images.
+    MipmapReference mipmapReference(imageValues, imageInfo,
+                                    outputType == kFloat && !gTestMaxImages);
+
     size_t nextLevelOffset = 0;
     size_t width_lod = imageInfo->width, height_lod = imageInfo->height;
     for( size_t lod = 0; (gTestMipmaps && (lod < imageInfo->num_mip_levels))|| (!gTestMipmaps && lod < 1); lod ++)
@@ -1527,16 +1529,16 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
             int retCode;
             switch (imageInfo->format->image_channel_order) {
             case CL_DEPTH:
-                retCode = validate_image_2D_depth_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr);
+                retCode = validate_image_2D_depth_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr, mipmapReference);
                 break;
             case CL_sRGB:
             case CL_sRGBx:
             case CL_sRGBA:
             case CL_sBGRA:
-                retCode = validate_image_2D_sRGB_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr);
+                retCode = validate_image_2D_sRGB_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr, mipmapReference);
                 break;
             default:
-                retCode = validate_image_2D_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr);
+                retCode = validate_image_2D_results((char*)imageValues + nextLevelOffset, resultValues, formatAbsoluteError, xOffsetValues, yOffsetValues, outputType, numTries, numClamped, imageSampler, imageInfo, lod, imagePtr, mipmapReference);
             }
             if (retCode)
                 return retCode;
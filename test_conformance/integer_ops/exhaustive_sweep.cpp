@@ -0,0 +1,321 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+
+#include "harness/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Results of up to this many input pairs are computed per kernel launch, and
+// this many launches are kept in flight while the host checks earlier ones.
+const cl_uint kSweepChunk = 1U << 24;
+const size_t kSweepDepth = 3;
+
+// Each thread pool job checks this many results
+const cl_uint kSweepJobSize = 1U << 16;
+
+template <typename T> struct SweepType;
+
+template <> struct SweepType<cl_char>
+{
+    typedef cl_short Wide;
+    static const char *name() { return "char"; }
+    static const char *unsigned_name() { return "uchar"; }
+    static const char *wide_name() { return "short"; }
+};
+
+template <> struct SweepType<cl_uchar>
+{
+    typedef cl_ushort Wide;
+    static const char *name() { return "uchar"; }
+    static const char *unsigned_name() { return "uchar"; }
+    static const char *wide_name() { return "ushort"; }
+};
+
+template <> struct SweepType<cl_short>
+{
+    typedef cl_int Wide;
+    static const char *name() { return "short"; }
+    static const char *unsigned_name() { return "ushort"; }
+    static const char *wide_name() { return "int"; }
+};
+
+template <> struct SweepType<cl_ushort>
+{
+    typedef cl_uint Wide;
+    static const char *name() { return "ushort"; }
+    static const char *unsigned_name() { return "ushort"; }
+    static const char *wide_name() { return "uint"; }
+};
+
+template <typename T, SmallIntegerBuiltin Builtin>
+using SweepResult = typename std::conditional<
+    Builtin == kSweepAbsDiff, typename std::make_unsigned<T>::type,
+    typename std::conditional<Builtin == kSweepUpsample,
+                              typename SweepType<T>::Wide, T>::type>::type;
+
+template <typename T, SmallIntegerBuiltin Builtin>
+static SweepResult<T, Builtin> sweep_reference(T a, T b)
+{
+    typedef SweepResult<T, Builtin> R;
+    typedef typename std::make_unsigned<T>::type U;
+    const cl_long lo = std::numeric_limits<T>::min();
+    const cl_long hi = std::numeric_limits<T>::max();
+
+    if constexpr (Builtin == kSweepAddSat)
+        return (R)std::min(std::max((cl_long)a + b, lo), hi);
+    else if constexpr (Builtin == kSweepSubSat)
+        return (R)std::min(std::max((cl_long)a - b, lo), hi);
+    else if constexpr (Builtin == kSweepAbsDiff)
+        return (R)((cl_long)a > b ? (cl_long)a - b : (cl_long)b - a);
+    else if constexpr (Builtin == kSweepMulHi)
+        return (R)(((cl_long)a * b) >> (sizeof(T) * 8));
+    else
+    {
+        typedef typename std::make_unsigned<R>::type UR;
+        return (R)(((UR)(R)a << (sizeof(T) * 8)) | (U)b);
+    }
+}
+
+const char *sweep_builtin_name(SmallIntegerBuiltin builtin)
+{
+    switch (builtin)
+    {
+        case kSweepAddSat: return "add_sat";
+        case kSweepSubSat: return "sub_sat";
+        case kSweepAbsDiff: return "abs_diff";
+        case kSweepMulHi: return "mul_hi";
+        case kSweepUpsample: return "upsample";
+    }
+    return "unknown";
+}
+
+template <typename T, SmallIntegerBuiltin Builtin>
+struct SweepCheckInfo
+{
+    const SweepResult<T, Builtin> *results;
+    cl_uint base;
+    cl_uint count;
+    std::atomic<int> errors;
+};
+
+// Input pair i is a = i >> bits, b = i & mask, as in the kernel
+template <typename T, SmallIntegerBuiltin Builtin>
+static cl_int sweep_check(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    auto *info = (SweepCheckInfo<T, Builtin> *)userInfo;
+    typedef typename std::make_unsigned<T>::type U;
+    const int bits = sizeof(T) * 8;
+
+    cl_uint begin = job_id * kSweepJobSize;
+    cl_uint end = std::min(begin + kSweepJobSize, info->count);
+    for (cl_uint k = begin; k < end; k++)
+    {
+        cl_uint i = info->base + k;
+        T a = (T)(U)(i >> bits);
+        T b = (T)(U)i;
+        SweepResult<T, Builtin> r = sweep_reference<T, Builtin>(a, b);
+        if (r == info->results[k]) continue;
+
+        if (info->errors++ < MAX_ERRORS_TO_PRINT)
+            log_error("ERROR: %s(%s 0x%" PRIx64 ", %s 0x%" PRIx64
+                      ") = 0x%" PRIx64 ", expected 0x%" PRIx64 "\n",
+                      sweep_builtin_name(Builtin), SweepType<T>::name(),
+                      (cl_ulong)(U)a, SweepType<T>::name(), (cl_ulong)(U)b,
+                      (cl_ulong)info->results[k], (cl_ulong)r);
+    }
+    return CL_SUCCESS;
+}
+
+template <typename T, SmallIntegerBuiltin Builtin>
+static int sweep_type(cl_context context, cl_command_queue queue)
+{
+    typedef SweepResult<T, Builtin> R;
+    const int bits = sizeof(T) * 8;
+    const cl_ulong total = 1ULL << (2 * bits);
+    const std::string type = SweepType<T>::name();
+    const std::string utype = SweepType<T>::unsigned_name();
+    const std::string name = sweep_builtin_name(Builtin);
+
+    std::string call = name + "(a, b)";
+    std::string result = type;
+    if (Builtin == kSweepAbsDiff) result = utype;
+    if (Builtin == kSweepUpsample)
+    {
+        call = name + "(a, as_" + utype + "(b))";
+        result = SweepType<T>::wide_name();
+    }
+    std::string source = "__kernel void sweep(__global " + result
+        + " *dst, uint base)\n"
+          "{\n"
+          "    uint i = base + get_global_id(0);\n"
+          "    "
+        + type + " a = as_" + type + "((" + utype + ")(i >> "
+        + std::to_string(bits) + "));\n"
+        + "    " + type + " b = as_" + type + "((" + utype + ")i);\n"
+        + "    dst[get_global_id(0)] = " + call + ";\n"
+        + "}\n";
+
+    // Smaller chunks for devices that can't allocate a full one
+    cl_device_id device;
+    int error = clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device),
+                                      &device, NULL);
+    test_error(error, "Unable to get the queue's device");
+    cl_ulong maxAllocSize;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(maxAllocSize), &maxAllocSize, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_MEM_ALLOC_SIZE");
+    const cl_uint chunk = (cl_uint)std::min(
+        { total, (cl_ulong)kSweepChunk, maxAllocSize / sizeof(R) });
+
+    const char *sourcePtr = source.c_str();
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        &sourcePtr, "sweep");
+    test_error(error, "Unable to create sweep kernel");
+
+    struct Slot
+    {
+        clMemWrapper buffer;
+        std::vector<R> results;
+        clEventWrapper readDone;
+        cl_ulong base;
+    };
+    std::vector<Slot> slots(kSweepDepth);
+    for (auto &slot : slots)
+    {
+        slot.buffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                     chunk * sizeof(R), NULL, &error);
+        test_error(error, "Unable to create sweep buffer");
+        slot.results.resize(chunk);
+    }
+
+    // Any failure leaves earlier reads in flight, so the callers of this
+    // wait for the queue to drain before the slots go away.
+    auto issue = [&](Slot &slot, cl_ulong base) {
+        size_t count = (size_t)std::min<cl_ulong>(chunk, total - base);
+        cl_uint base32 = (cl_uint)base;
+        slot.base = base;
+        slot.readDone = NULL;
+        int err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &slot.buffer);
+        err |= clSetKernelArg(kernel, 1, sizeof(base32), &base32);
+        test_error(err, "Unable to set sweep kernel arguments");
+        err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &count, NULL, 0,
+                                     NULL, NULL);
+        test_error(err, "Unable to enqueue sweep kernel");
+        err = clEnqueueReadBuffer(queue, slot.buffer, CL_FALSE, 0,
+                                  count * sizeof(R), slot.results.data(), 0,
+                                  NULL, &slot.readDone);
+        test_error(err, "Unable to read sweep results");
+        err = clFlush(queue);
+        test_error(err, "clFlush failed");
+        return CL_SUCCESS;
+    };
+
+    log_info("\t%s %s: %" PRIu64 " input pairs\n", name.c_str(), type.c_str(),
+             total);
+
+    // Keep the device busy with the next chunks while the host checks one
+    cl_ulong next = 0;
+    for (size_t s = 0; s < slots.size() && next < total; s++, next += chunk)
+    {
+        error = issue(slots[s], next);
+        if (error) break;
+    }
+
+    for (cl_ulong base = 0; !error && base < total; base += chunk)
+    {
+        Slot &slot = slots[(base / chunk) % slots.size()];
+        error = clWaitForEvents(1, &slot.readDone);
+        if (error)
+        {
+            print_error(error, "Unable to wait for sweep results");
+            break;
+        }
+
+        SweepCheckInfo<T, Builtin> info;
+        info.results = slot.results.data();
+        info.base = (cl_uint)slot.base;
+        info.count = (cl_uint)std::min<cl_ulong>(chunk, total - slot.base);
+        info.errors = 0;
+        error = ThreadPool_Do(sweep_check<T, Builtin>,
+                              (info.count + kSweepJobSize - 1) / kSweepJobSize,
+                              &info);
+        if (error)
+        {
+            print_error(error, "Unable to check sweep results");
+            break;
+        }
+        if (info.errors)
+        {
+            log_error("ERROR: %s %s failed %d times in the chunk at 0x%" PRIx64
+                      "\n",
+                      name.c_str(), type.c_str(), (int)info.errors, slot.base);
+            error = -1;
+            break;
+        }
+
+        if (next < total)
+        {
+            error = issue(slot, next);
+            next += chunk;
+        }
+    }
+
+    clFinish(queue);
+    return error;
+}
+
+template <SmallIntegerBuiltin Builtin>
+static int sweep_builtin(cl_context context, cl_command_queue queue)
+{
+    int failures = 0;
+    failures += sweep_type<cl_char, Builtin>(context, queue) != 0;
+    failures += sweep_type<cl_uchar, Builtin>(context, queue) != 0;
+    failures += sweep_type<cl_short, Builtin>(context, queue) != 0;
+    failures += sweep_type<cl_ushort, Builtin>(context, queue) != 0;
+    return failures ? -1 : 0;
+}
+
+}
+
+int test_exhaustive_sweep(cl_context context, cl_command_queue queue,
+                          SmallIntegerBuiltin builtin)
+{
+    log_info("Exhaustive %s sweep over char, uchar, short and ushort\n",
+             sweep_builtin_name(builtin));
+
+    switch (builtin)
+    {
+        case kSweepAddSat: return sweep_builtin<kSweepAddSat>(context, queue);
+        case kSweepSubSat: return sweep_builtin<kSweepSubSat>(context, queue);
+        case kSweepAbsDiff:
+            return sweep_builtin<kSweepAbsDiff>(context, queue);
+        case kSweepMulHi: return sweep_builtin<kSweepMulHi>(context, queue);
+        case kSweepUpsample:
+            return sweep_builtin<kSweepUpsample>(context, queue);
+    }
+    return -1;
+}
@@ -17,8 +17,10 @@
 
 #include <stdio.h>
 #include <string.h>
+#include "harness/parseParameters.h"
 #include "harness/testHarness.h"
 #include "harness/mt19937.h"
+#include "testBase.h"
 
 #if !defined(_WIN32)
 #include <unistd.h>
@@ -87,8 +89,17 @@ void fill_test_values( cl_long *outBufferA, cl_long *outBufferB, size_t numEleme
     }
 }
 
+bool gExhaustive = false;
+
 int main(int argc, const char *argv[])
 {
+    argc = parseSuiteOptions(
+        argc, argv, "Integer ops",
+        { { "--exhaustive", &gExhaustive,
+            "Also check add_sat, sub_sat, abs_diff, mul_hi and upsample on "
+            "every pair of 8 and 16 bit inputs" } });
+    if (argc < 0) return EXIT_FAILURE;
+
     return runTestHarness(argc, argv, test_registry::getInstance().num_tests(),
                           test_registry::getInstance().definitions(), false, 0);
 }
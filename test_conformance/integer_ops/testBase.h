@@ -33,6 +33,22 @@
 extern void fill_test_values(cl_long *outBufferA, cl_long *outBufferB,
                              size_t numElements, MTdata d);
 
+// Set by --exhaustive: also check the builtins below on every pair of char,
+// uchar, short and ushort inputs.
+extern bool gExhaustive;
+
+enum SmallIntegerBuiltin
+{
+    kSweepAddSat,
+    kSweepSubSat,
+    kSweepAbsDiff,
+    kSweepMulHi,
+    kSweepUpsample
+};
+
+extern int test_exhaustive_sweep(cl_context context, cl_command_queue queue,
+                                 SmallIntegerBuiltin builtin);
+
 #endif // _testBase_h
 
 
@@ -389,6 +389,9 @@ REGISTER_TEST(integer_abs_diff)
     }
 
 
+    if (gExhaustive && test_exhaustive_sweep(context, queue, kSweepAbsDiff))
+        fail_count++;
+
     if(fail_count) {
         log_info("Failed on %d types\n", fail_count);
         return -1;
@@ -360,6 +360,9 @@ REGISTER_TEST(integer_add_sat)
         clReleaseMemObject( streams[2] );
         log_info( "done\n" );
     }
+    if (gExhaustive && test_exhaustive_sweep(context, queue, kSweepAddSat))
+        fail_count++;
+
     if(fail_count) {
         log_info("Failed on %d types\n", fail_count);
         return -1;
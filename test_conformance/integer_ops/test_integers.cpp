@@ -1201,7 +1201,13 @@ bool verify_integer_mul_hi( void *sourceA, void *sourceB, void *destination, Exp
 
 REGISTER_TEST(integer_mul_hi)
 {
-    return test_two_param_integer_fn( queue, context, "mul_hi", verify_integer_mul_hi );
+    int error = test_two_param_integer_fn(queue, context, "mul_hi",
+                                          verify_integer_mul_hi);
+
+    if (gExhaustive && test_exhaustive_sweep(context, queue, kSweepMulHi))
+        error = -1;
+
+    return error;
 }
 
 bool verify_integer_rotate( void *sourceA, void *sourceB, void *destination, ExplicitType vecType )
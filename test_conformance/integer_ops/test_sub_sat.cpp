@@ -358,6 +358,9 @@ REGISTER_TEST(integer_sub_sat)
         clReleaseMemObject( streams[2] );
         log_info( "done\n" );
     }
+    if (gExhaustive && test_exhaustive_sweep(context, queue, kSweepSubSat))
+        fail_count++;
+
     if(fail_count) {
         log_info("Failed on %d types\n", fail_count);
         return -1;
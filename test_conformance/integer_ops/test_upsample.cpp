@@ -262,5 +262,9 @@ REGISTER_TEST(integer_upsample)
             free( expected );
         }
     }
+
+    if (gExhaustive && test_exhaustive_sweep(context, queue, kSweepUpsample))
+        err = -1;
+
     return err;
 }
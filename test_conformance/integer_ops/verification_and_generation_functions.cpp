@@ -20,7 +20,12 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <cinttypes>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "harness/conversions.h"
 
@@ -80,204 +85,258 @@ const char *test_names[] = {
     "!",  // 22
 };
 
-// =======================================
-// long
-// =======================================
-int
-verify_long(int test, size_t vector_size, cl_long *inptrA, cl_long *inptrB, cl_long *outptr, size_t n)
+// The operations, in the same order as tests[] and test_names[]
+enum IntegerOp
+{
+    kAdd = 0,
+    kSub,
+    kMul,
+    kDiv,
+    kRem,
+    kAnd,
+    kOr,
+    kXor,
+    kShiftRightByVector,
+    kShiftLeftByVector,
+    kShiftRightByScalar,
+    kShiftLeftByScalar,
+    kNot,
+    kSelect,
+    kLogicalAnd,
+    kLogicalOr,
+    kLess,
+    kGreater,
+    kLessEqual,
+    kGreaterEqual,
+    kEqual,
+    kNotEqual,
+    kLogicalNot,
+    kNumIntegerOps
+};
+
+// Scalar char and short operands are promoted to int before the operation,
+// vector ones are not. This is what the shift masks have to follow.
+template <typename T, bool Scalar> constexpr int integer_op_shift_mask()
+{
+    return (Scalar ? sizeof(decltype(+T())) : sizeof(T)) * 8 - 1;
+}
+
+// The expected result of one element. groupA and groupB are the first
+// elements of the vector the element is in, which is what the scalar shifts
+// and the select condition use. Undefined results (division by zero or
+// overflow) return the device result, so that they always match.
+template <typename T, int Op, bool Scalar>
+static inline T integer_op_reference(T a, T b, T groupA, T groupB, T out)
+{
+    typedef decltype(+a) P;
+    typedef typename std::make_unsigned<P>::type U;
+    constexpr P shiftMask = integer_op_shift_mask<T, Scalar>();
+    // Scalars are set to 1/0, vectors to -1/0
+    constexpr T isTrue = Scalar ? (T)1 : (T)-1;
+
+    if constexpr (Op == kAdd) return (T)((U)a + (U)b);
+    else if constexpr (Op == kSub)
+        return (T)((U)a - (U)b);
+    else if constexpr (Op == kMul)
+        return (T)((U)a * (U)b);
+    else if constexpr (Op == kDiv || Op == kRem)
+    {
+        bool undefined = b == 0
+            || (std::is_signed<T>::value && b == (T)-1
+                && a == std::numeric_limits<T>::min());
+        P divisor = undefined ? (P)1 : (P)b;
+        T r = Op == kDiv ? (T)(a / divisor) : (T)(a % divisor);
+        return undefined ? out : r;
+    }
+    else if constexpr (Op == kAnd)
+        return a & b;
+    else if constexpr (Op == kOr)
+        return a | b;
+    else if constexpr (Op == kXor)
+        return a ^ b;
+    else if constexpr (Op == kShiftRightByVector)
+        return (T)((P)a >> ((P)b & shiftMask));
+    else if constexpr (Op == kShiftLeftByVector)
+        return (T)((U)a << ((P)b & shiftMask));
+    else if constexpr (Op == kShiftRightByScalar)
+        return (T)((P)a >> ((P)groupB & shiftMask));
+    else if constexpr (Op == kShiftLeftByScalar)
+        return (T)((U)a << ((P)groupB & shiftMask));
+    else if constexpr (Op == kNot)
+        return (T)~a;
+    else if constexpr (Op == kSelect)
+        return groupA < groupB ? a : b;
+    else if constexpr (Op == kLogicalAnd)
+        return a && b ? isTrue : (T)0;
+    else if constexpr (Op == kLogicalOr)
+        return a || b ? isTrue : (T)0;
+    else if constexpr (Op == kLess)
+        return a < b ? isTrue : (T)0;
+    else if constexpr (Op == kGreater)
+        return a > b ? isTrue : (T)0;
+    else if constexpr (Op == kLessEqual)
+        return a <= b ? isTrue : (T)0;
+    else if constexpr (Op == kGreaterEqual)
+        return a >= b ? isTrue : (T)0;
+    else if constexpr (Op == kEqual)
+        return a == b ? isTrue : (T)0;
+    else if constexpr (Op == kNotEqual)
+        return a != b ? isTrue : (T)0;
+    else
+        return !a ? isTrue : (T)0;
+}
+
+// Computes the expected results of elements [begin, end), which start and end
+// on vector boundaries. The operation is fixed at compile time, so each of
+// these loops is free of branches and vectorizes where the target allows.
+template <typename T, int Op, bool Scalar>
+static void integer_op_reference_block(const T *a, const T *b, const T *out,
+                                       T *ref, size_t begin, size_t end,
+                                       size_t vector_size)
+{
+    if constexpr (Op == kShiftRightByScalar || Op == kShiftLeftByScalar
+                  || Op == kSelect)
+    {
+        for (size_t j = begin; j < end; j += vector_size)
+            for (size_t i = j; i < j + vector_size; i++)
+                ref[i - begin] = integer_op_reference<T, Op, Scalar>(
+                    a[i], b[i], a[j], b[j], out[i]);
+    }
+    else
+    {
+        for (size_t i = begin; i < end; i++)
+            ref[i - begin] = integer_op_reference<T, Op, Scalar>(
+                a[i], b[i], a[i], b[i], out[i]);
+    }
+}
+
+template <typename T> static cl_ulong integer_op_bits(T value)
+{
+    return (cl_ulong)(typename std::make_unsigned<T>::type)value;
+}
+
+template <typename T, bool Scalar>
+static void report_integer_op_failure(const char *type_name, int test,
+                                      size_t i, size_t j, size_t n,
+                                      const T *a, const T *b, T r, T out)
+{
+    const int shiftMask = integer_op_shift_mask<T, Scalar>();
+
+    if (test == kSelect)
+    {
+        log_error("%s Verification failed at element %zu of %zu (%zu): "
+                  "(0x%" PRIx64 " < 0x%" PRIx64 ") ? 0x%" PRIx64
+                  " : 0x%" PRIx64 " = 0x%" PRIx64 ", got 0x%" PRIx64 "\n",
+                  type_name, i, n, j, integer_op_bits(a[j]),
+                  integer_op_bits(b[j]), integer_op_bits(a[i]),
+                  integer_op_bits(b[i]), integer_op_bits(r),
+                  integer_op_bits(out));
+        return;
+    }
+
+    // The scalar shifts take their shift amount from the start of the vector
+    bool scalarShift =
+        test == kShiftRightByScalar || test == kShiftLeftByScalar;
+    size_t k = scalarShift ? j : i;
+    log_error("%s Verification failed at element %zu of %zu (%zu): "
+              "0x%" PRIx64 " %s 0x%" PRIx64 " = 0x%" PRIx64 ", got 0x%" PRIx64
+              "\n",
+              type_name, i, n, j, integer_op_bits(a[i]), tests[test],
+              integer_op_bits(b[k]), integer_op_bits(r),
+              integer_op_bits(out));
+
+    // Shift is tricky
+    if (test >= kShiftRightByVector && test <= kShiftLeftByScalar)
+    {
+        log_error("\t1) %s shift failure at element %zu: original is "
+                  "0x%" PRIx64 " %s %d (0x%" PRIx64 ")\n",
+                  scalarShift ? "Scalar" : "Vector", i, integer_op_bits(a[i]),
+                  tests[test], (int)b[k], integer_op_bits(b[k]));
+        log_error("\t2) Take the %d LSBs of the shift to get the final shift "
+                  "amount %d (0x%x).\n",
+                  (int)log2(shiftMask + 1), (int)b[k] & shiftMask,
+                  (int)b[k] & shiftMask);
+    }
+}
+
+template <typename T, int Op, bool Scalar>
+static int verify_integer_op(const char *type_name, size_t vector_size,
+                             const T *a, const T *b, const T *out, size_t n)
 {
-    cl_long            r, shift_mask = (sizeof(cl_long)*8)-1;
-    size_t         i, j;
-    int count=0;
+    // Work in blocks that fit in L1 and hold whole vectors
+    const size_t block = vector_size * (4096 / sizeof(T) / vector_size);
+    std::vector<T> ref(block);
+    int count = 0;
 
-    for (j=0; j<n; j += vector_size )
+    for (size_t begin = 0; begin < n; begin += block)
     {
-        for( i = j; i < j + vector_size; i++ )
+        size_t end = std::min(n, begin + block);
+        integer_op_reference_block<T, Op, Scalar>(a, b, out, ref.data(), begin,
+                                                  end, vector_size);
+        if (!memcmp(ref.data(), out + begin, (end - begin) * sizeof(T)))
+            continue;
+
+        for (size_t i = begin; i < end; i++)
         {
-            switch (test) {
-                case 0:
-                    r = inptrA[i] + inptrB[i];
-                    break;
-                case 1:
-                    r = inptrA[i] - inptrB[i];
-                    break;
-                case 2:
-                    r = inptrA[i] * inptrB[i];
-                    break;
-                case 3:
-                    if (inptrB[i] == 0 || (inptrB[i] == -1 && inptrA[i] == CL_LONG_MIN))
-                        continue;
-                    else
-                        r = inptrA[i] / inptrB[i];
-                    break;
-                case 4:
-                    if (inptrB[i] == 0 || (inptrB[i] == -1 && inptrA[i] == CL_LONG_MIN))
-                        continue;
-                    else
-                        r = inptrA[i] % inptrB[i];
-                    break;
-                case 5:
-                    r = inptrA[i] & inptrB[i];
-                    break;
-                case 6:
-                    r = inptrA[i] | inptrB[i];
-                    break;
-                case 7:
-                    r = inptrA[i] ^ inptrB[i];
-                    break;
-                case 8:
-                    r = inptrA[i] >> (inptrB[i] & shift_mask);
-                    break;
-                case 9:
-                    r = inptrA[i] << (inptrB[i] & shift_mask);
-                    break;
-                case 10:
-                    r = inptrA[i] >> (inptrB[j] & shift_mask);
-                    break;
-                case 11:
-                    r = inptrA[i] << (inptrB[j] & shift_mask);
-                    break;
-                case 12:
-                    r = ~inptrA[i];
-                    break;
-                case 13:
-                    r = (inptrA[j] < inptrB[j]) ? inptrA[i] : inptrB[i];
-                    break;
-                case 14:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] && inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 15:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] || inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 16:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] < inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 17:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] > inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 18:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] <= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 19:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] >= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 20:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] == inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 21:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] != inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 22:
-                    // Scalars are set to 1/0
-                    r = !inptrA[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                default:
-                    log_error("Invalid test: %d\n", test);
-                    return -1;
-                    break;
-            }
-            if (r != outptr[i]) {
-                // Shift is tricky
-                if (test == 8 || test == 9) {
-                    log_error("cl_long Verification failed at element %zu of "
-                              "%zu : 0x%" PRIx64 " %s 0x%" PRIx64
-                              " = 0x%" PRIx64 ", got 0x%" PRIx64 "\n",
-                              i, n, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                    log_error(
-                        "\t1) Vector shift failure at element %zu: original is "
-                        "0x%" PRIx64 " %s %d (0x%" PRIx64 ")\n",
-                        i, inptrA[i], tests[test], (int)inptrB[i], inptrB[i]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the "
-                              "final shift amount %" PRId64 " (0x%" PRIx64
-                              ").\n",
-                              (int)log2(sizeof(cl_long) * 8),
-                              inptrB[i] & shift_mask, inptrB[i] & shift_mask);
-                }
-                else if (test == 10 || test == 11) {
-
-                    log_error("cl_long Verification failed at element %zu of "
-                              "%zu (%zu): 0x%" PRIx64 " %s 0x%" PRIx64
-                              " = 0x%" PRIx64 ", got 0x%" PRIx64 "\n",
-                              i, n, j, inptrA[i], tests[test], inptrB[j], r,
-                              outptr[i]);
-                    log_error(
-                        "\t1) Scalar shift failure at element %zu: original is "
-                        "0x%" PRIx64 " %s %d (0x%" PRIx64 ")\n",
-                        i, inptrA[i], tests[test], (int)inptrB[j], inptrB[j]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the "
-                              "final shift amount %" PRId64 " (0x%" PRIx64
-                              ").\n",
-                              (int)log2(sizeof(cl_long) * 8),
-                              inptrB[j] & shift_mask, inptrB[j] & shift_mask);
-                } else if (test == 13) {
-                    log_error("cl_int Verification failed at element %zu "
-                              "(%zu): (0x%" PRIx64 " < 0x%" PRIx64
-                              ") ? 0x%" PRIx64 " : 0x%" PRIx64 " = 0x%" PRIx64
-                              ", got 0x%" PRIx64 "\n",
-                              i, j, inptrA[j], inptrB[j], inptrA[i], inptrB[i],
-                              r, outptr[i]);
-                } else {
-                    log_error("cl_long Verification failed at element %zu of "
-                              "%zu: 0x%" PRIx64 " %s 0x%" PRIx64 " = 0x%" PRIx64
-                              ", got 0x%" PRIx64 "\n",
-                              i, n, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                }
-                count++;
-                if (count >= MAX_ERRORS_TO_PRINT) {
-                    log_error("Further errors ignored.\n");
-                    return -1;
-                }
+            if (ref[i - begin] == out[i]) continue;
+
+            size_t j = i - i % vector_size;
+            report_integer_op_failure<T, Scalar>(type_name, Op, i, j, n, a, b,
+                                                 ref[i - begin], out[i]);
+            if (++count >= MAX_ERRORS_TO_PRINT)
+            {
+                log_error("Further errors ignored.\n");
+                return -1;
             }
         }
     }
 
-    if (count) return -1; else return 0;
+    return count ? -1 : 0;
+}
+
+template <typename T, int Op>
+static int verify_integer_op(const char *type_name, size_t vector_size,
+                             const T *a, const T *b, const T *out, size_t n)
+{
+    return vector_size == 1
+        ? verify_integer_op<T, Op, true>(type_name, vector_size, a, b, out, n)
+        : verify_integer_op<T, Op, false>(type_name, vector_size, a, b, out,
+                                          n);
+}
+
+template <typename T, size_t... Ops>
+static int verify_integer(const char *type_name, int test, size_t vector_size,
+                          const T *a, const T *b, const T *out, size_t n,
+                          std::index_sequence<Ops...>)
+{
+    typedef int (*VerifyFunc)(const char *, size_t, const T *, const T *,
+                              const T *, size_t);
+    static const VerifyFunc verifiers[] = { verify_integer_op<T, Ops>... };
+
+    if (test < 0 || test >= kNumIntegerOps)
+    {
+        log_error("Invalid test: %d\n", test);
+        return -1;
+    }
+    return verifiers[test](type_name, vector_size, a, b, out, n);
+}
+
+template <typename T>
+static int verify_integer(const char *type_name, int test, size_t vector_size,
+                          const T *a, const T *b, const T *out, size_t n)
+{
+    return verify_integer(type_name, test, vector_size, a, b, out, n,
+                          std::make_index_sequence<kNumIntegerOps>());
+}
+
+// =======================================
+// long
+// =======================================
+int verify_long(int test, size_t vector_size, cl_long *inptrA, cl_long *inptrB,
+                cl_long *outptr, size_t n)
+{
+    return verify_integer("cl_long", test, vector_size, inptrA, inptrB, outptr,
+                          n);
 }
 
 void
@@ -309,199 +368,11 @@ init_long_data(uint64_t indx, int num_elements, cl_long *input_ptr[], MTdata d)
 // =======================================
 // ulong
 // =======================================
-int
-verify_ulong(int test, size_t vector_size, cl_ulong *inptrA, cl_ulong *inptrB, cl_ulong *outptr, size_t n)
+int verify_ulong(int test, size_t vector_size, cl_ulong *inptrA,
+                 cl_ulong *inptrB, cl_ulong *outptr, size_t n)
 {
-    cl_ulong        r, shift_mask = (sizeof(cl_ulong)*8)-1;
-    size_t          i, j;
-    int count=0;
-
-    for (j=0; j<n; j += vector_size )
-    {
-        for( i = j; i < j + vector_size; i++ )
-        {
-            switch (test) {
-                case 0:
-                    r = inptrA[i] + inptrB[i];
-                    break;
-                case 1:
-                    r = inptrA[i] - inptrB[i];
-                    break;
-                case 2:
-                    r = inptrA[i] * inptrB[i];
-                    break;
-                case 3:
-                    if (inptrB[i] == 0)
-                        continue;
-                    else
-                        r = inptrA[i] / inptrB[i];
-                    break;
-                case 4:
-                    if (inptrB[i] == 0)
-                        continue;
-                    else
-                        r = inptrA[i] % inptrB[i];
-                    break;
-                case 5:
-                    r = inptrA[i] & inptrB[i];
-                    break;
-                case 6:
-                    r = inptrA[i] | inptrB[i];
-                    break;
-                case 7:
-                    r = inptrA[i] ^ inptrB[i];
-                    break;
-                case 8:
-                    r = inptrA[i] >> (inptrB[i] & shift_mask);
-                    break;
-                case 9:
-                    r = inptrA[i] << (inptrB[i] & shift_mask);
-                    break;
-                case 10:
-                    r = inptrA[i] >> (inptrB[j] & shift_mask);
-                    break;
-                case 11:
-                    r = inptrA[i] << (inptrB[j] & shift_mask);
-                    break;
-                case 12:
-                    r = ~inptrA[i];
-                    break;
-                case 13:
-                    r = (inptrA[j] < inptrB[j]) ? inptrA[i] : inptrB[i];
-                    break;
-                case 14:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] && inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 15:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] || inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 16:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] < inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 17:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] > inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 18:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] <= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 19:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] >= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 20:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] == inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 21:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] != inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 22:
-                    // Scalars are set to 1/0
-                    r = !inptrA[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                default:
-                    log_error("Invalid test: %d\n", test);
-                    return -1;
-                    break;
-            }
-            if (r != outptr[i]) {
-                // Shift is tricky
-                if (test == 8 || test == 9) {
-                    log_error("cl_ulong Verification failed at element %zu of "
-                              "%zu: 0x%" PRIx64 " %s 0x%" PRIx64 " = 0x%" PRIx64
-                              ", got 0x%" PRIx64 "\n",
-                              i, n, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                    log_error("\t1) Shift failure at element %zu: original is "
-                              "0x%" PRIx64 " %s %d (0x%" PRIx64 ")\n",
-                              i, inptrA[i], tests[test], (int)inptrB[i],
-                              inptrB[i]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the "
-                              "final shift amount %" PRIu64 " (0x%" PRIx64
-                              ").\n",
-                              (int)log2(sizeof(cl_ulong) * 8),
-                              inptrB[i] & shift_mask, inptrB[i] & shift_mask);
-                }
-                else if (test == 10 || test == 11) {
-                    log_error("cl_ulong Verification failed at element %zu of "
-                              "%zu (%zu): 0x%" PRIx64 " %s 0x%" PRIx64
-                              " = 0x%" PRIx64 ", got 0x%" PRIx64 "\n",
-                              i, n, j, inptrA[i], tests[test], inptrB[j], r,
-                              outptr[i]);
-                    log_error(
-                        "\t1) Scalar shift failure at element %zu: original is "
-                        "0x%" PRIx64 " %s %d (0x%" PRIx64 ")\n",
-                        i, inptrA[i], tests[test], (int)inptrB[j], inptrB[j]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the "
-                              "final shift amount %" PRId64 " (0x%" PRIx64
-                              ").\n",
-                              (int)log2(sizeof(cl_long) * 8),
-                              inptrB[j] & shift_mask, inptrB[j] & shift_mask);
-                } else if (test == 13) {
-                    log_error("cl_int Verification failed at element %zu of "
-                              "%zu (%zu): (0x%" PRIx64 " < 0x%" PRIx64
-                              ") ? 0x%" PRIx64 " : 0x%" PRIx64 " = 0x%" PRIx64
-                              ", got 0x%" PRIx64 "\n",
-                              i, n, j, inptrA[j], inptrB[j], inptrA[i],
-                              inptrB[i], r, outptr[i]);
-                } else {
-                    log_error("cl_ulong Verification failed at element %zu of "
-                              "%zu: 0x%" PRIx64 " %s 0x%" PRIx64 " = 0x%" PRIx64
-                              ", got 0x%" PRIx64 "\n",
-                              i, n, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                }
-                count++;
-                if (count >= MAX_ERRORS_TO_PRINT) {
-                    log_error("Further errors ignored.\n");
-                    return -1;
-                }
-            }
-        }
-    }
-    if (count) return -1; else return 0;
+    return verify_integer("cl_ulong", test, vector_size, inptrA, inptrB, outptr,
+                          n);
 }
 
 void
@@ -540,188 +411,11 @@ init_ulong_data(uint64_t indx, int num_elements, cl_ulong *input_ptr[], MTdata d
 // =======================================
 // int
 // =======================================
-int
-verify_int(int test, size_t vector_size, cl_int *inptrA, cl_int *inptrB, cl_int *outptr, size_t n)
+int verify_int(int test, size_t vector_size, cl_int *inptrA, cl_int *inptrB,
+               cl_int *outptr, size_t n)
 {
-    cl_int            r, shift_mask = (sizeof(cl_int)*8)-1;
-    size_t          i, j;
-    int count=0;
-
-    for (j=0; j<n; j += vector_size )
-    {
-        for( i = j; i < j + vector_size; i++ )
-        {
-            switch (test) {
-                case 0:
-                    r = inptrA[i] + inptrB[i];
-                    break;
-                case 1:
-                    r = inptrA[i] - inptrB[i];
-                    break;
-                case 2:
-                    r = inptrA[i] * inptrB[i];
-                    break;
-                case 3:
-                    if (inptrB[i] == 0 || (inptrB[i] == -1 && inptrA[i] == CL_INT_MIN))
-                        continue;
-                    else
-                        r = inptrA[i] / inptrB[i];
-                    break;
-                case 4:
-                    if (inptrB[i] == 0 || (inptrB[i] == -1 && inptrA[i] == CL_INT_MIN))
-                        continue;
-                    else
-                        r = inptrA[i] % inptrB[i];
-                    break;
-                case 5:
-                    r = inptrA[i] & inptrB[i];
-                    break;
-                case 6:
-                    r = inptrA[i] | inptrB[i];
-                    break;
-                case 7:
-                    r = inptrA[i] ^ inptrB[i];
-                    break;
-                case 8:
-                    r = inptrA[i] >> (inptrB[i] & shift_mask);
-                    break;
-                case 9:
-                    r = inptrA[i] << (inptrB[i] & shift_mask);
-                    break;
-                case 10:
-                    r = inptrA[i] >> (inptrB[j] & shift_mask);
-                    break;
-                case 11:
-                    r = inptrA[i] << (inptrB[j] & shift_mask);
-                    break;
-                case 12:
-                    r = ~inptrA[i];
-                    break;
-                case 13:
-                    r = (inptrA[j] < inptrB[j]) ? inptrA[i] : inptrB[i];
-                    break;
-                case 14:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] && inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 15:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] || inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 16:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] < inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 17:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] > inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 18:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] <= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 19:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] >= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 20:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] == inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 21:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] != inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 22:
-                    // Scalars are set to 1/0
-                    r = !inptrA[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                default:
-                    log_error("Invalid test: %d\n", test);
-                    return -1;
-                    break;
-            }
-            if (r != outptr[i]) {
-                // Shift is tricky
-                if (test == 8 || test == 9) {
-                    log_error("cl_int Verification failed at element %zu: 0x%x "
-                              "%s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                    log_error("\t1) Shift failure at element %zu: original is "
-                              "0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[i],
-                              inptrB[i]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_int)*8),  inptrB[i]&shift_mask, inptrB[i]&shift_mask);
-                }
-                else if (test == 10 || test == 11) {
-                    log_error("cl_int Verification failed at element %zu "
-                              "(%zu): 0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, j, inptrA[i], tests[test], inptrB[j], r,
-                              outptr[i]);
-                    log_error("\t1) Scalar shift failure at element %zu: "
-                              "original is 0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[j],
-                              inptrB[j]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_int)*8),  inptrB[j]&shift_mask, inptrB[j]&shift_mask);
-                } else if (test == 13) {
-                    log_error(
-                        "cl_int Verification failed at element %zu (%zu): "
-                        "(0x%x < 0x%x) ? 0x%x : 0x%x = 0x%x, got 0x%x\n",
-                        i, j, inptrA[j], inptrB[j], inptrA[i], inptrB[i], r,
-                        outptr[i]);
-                } else {
-                    log_error("cl_int Verification failed at element %zu: 0x%x "
-                              "%s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                }
-                count++;
-                if (count >= MAX_ERRORS_TO_PRINT) {
-                    log_error("Further errors ignored.\n");
-                    return -1;
-                }
-            }
-        }
-    }
-
-    if (count) return -1; else return 0;
+    return verify_integer("cl_int", test, vector_size, inptrA, inptrB, outptr,
+                          n);
 }
 
 void
@@ -753,187 +447,11 @@ init_int_data(uint64_t indx, int num_elements, cl_int *input_ptr[], MTdata d)
 // =======================================
 // uint
 // =======================================
-int
-verify_uint(int test, size_t vector_size, cl_uint *inptrA, cl_uint *inptrB, cl_uint *outptr, size_t n)
+int verify_uint(int test, size_t vector_size, cl_uint *inptrA, cl_uint *inptrB,
+                cl_uint *outptr, size_t n)
 {
-    cl_uint            r, shift_mask = (sizeof(cl_uint)*8)-1;
-    size_t          i, j;
-    int count=0;
-
-    for (j=0; j<n; j += vector_size )
-    {
-        for( i = j; i < j + vector_size; i++ )
-        {
-            switch (test) {
-                case 0:
-                    r = inptrA[i] + inptrB[i];
-                    break;
-                case 1:
-                    r = inptrA[i] - inptrB[i];
-                    break;
-                case 2:
-                    r = inptrA[i] * inptrB[i];
-                    break;
-                case 3:
-                    if (inptrB[i] == 0)
-                        continue;
-                    else
-                        r = inptrA[i] / inptrB[i];
-                    break;
-                case 4:
-                    if (inptrB[i] == 0)
-                        continue;
-                    else
-                        r = inptrA[i] % inptrB[i];
-                    break;
-                case 5:
-                    r = inptrA[i] & inptrB[i];
-                    break;
-                case 6:
-                    r = inptrA[i] | inptrB[i];
-                    break;
-                case 7:
-                    r = inptrA[i] ^ inptrB[i];
-                    break;
-                case 8:
-                    r = inptrA[i] >> (inptrB[i] & shift_mask);
-                    break;
-                case 9:
-                    r = inptrA[i] << (inptrB[i] & shift_mask);
-                    break;
-                case 10:
-                    r = inptrA[i] >> (inptrB[j] & shift_mask);
-                    break;
-                case 11:
-                    r = inptrA[i] << (inptrB[j] & shift_mask);
-                    break;
-                case 12:
-                    r = ~inptrA[i];
-                    break;
-                case 13:
-                    r = (inptrA[j] < inptrB[j]) ? inptrA[i] : inptrB[i];
-                    break;
-                case 14:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] && inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 15:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] || inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 16:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] < inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 17:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] > inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 18:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] <= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 19:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] >= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 20:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] == inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 21:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] != inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 22:
-                    // Scalars are set to 1/0
-                    r = !inptrA[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                default:
-                    log_error("Invalid test: %d\n", test);
-                    return -1;
-                    break;
-            }
-            if (r != outptr[i]) {
-                // Shift is tricky
-                if (test == 8 || test == 9) {
-                    log_error("cl_uint Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                    log_error("\t1) Shift failure at element %zu: original is "
-                              "0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[i],
-                              inptrB[i]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_uint)*8),  inptrB[i]&shift_mask, inptrB[i]&shift_mask);
-                }
-                else if (test == 10 || test == 11) {
-                    log_error("cl_uint Verification failed at element %zu "
-                              "(%zu): 0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, j, inptrA[i], tests[test], inptrB[j], r,
-                              outptr[i]);
-                    log_error("\t1) Scalar shift failure at element %zu: "
-                              "original is 0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[j],
-                              inptrB[j]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_uint)*8),  inptrB[j]&shift_mask, inptrB[j]&shift_mask);
-                } else if (test == 13) {
-                    log_error(
-                        "cl_int Verification failed at element %zu (%zu): "
-                        "(0x%x < 0x%x) ? 0x%x : 0x%x = 0x%x, got 0x%x\n",
-                        i, j, inptrA[j], inptrB[j], inptrA[i], inptrB[i], r,
-                        outptr[i]);
-                } else {
-                    log_error("cl_uint Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                }
-                count++;
-                if (count >= MAX_ERRORS_TO_PRINT) {
-                    log_error("Further errors ignored.\n");
-                    return -1;
-                }
-            }
-        }
-    }
-    if (count) return -1; else return 0;
+    return verify_integer("cl_uint", test, vector_size, inptrA, inptrB, outptr,
+                          n);
 }
 
 void
@@ -965,190 +483,11 @@ init_uint_data(uint64_t indx, int num_elements, cl_uint *input_ptr[], MTdata d)
 // =======================================
 // short
 // =======================================
-int
-verify_short(int test, size_t vector_size, cl_short *inptrA, cl_short *inptrB, cl_short *outptr, size_t n)
+int verify_short(int test, size_t vector_size, cl_short *inptrA,
+                 cl_short *inptrB, cl_short *outptr, size_t n)
 {
-    cl_short r;
-    cl_int   shift_mask = vector_size == 1 ? (cl_int)(sizeof(cl_int)*8)-1
-    : (cl_int)(sizeof(cl_short)*8)-1;
-    size_t   i, j;
-    int      count=0;
-
-    for (j=0; j<n; j += vector_size )
-    {
-        for( i = j; i < j + vector_size; i++ )
-        {
-            switch (test) {
-                case 0:
-                    r = inptrA[i] + inptrB[i];
-                    break;
-                case 1:
-                    r = inptrA[i] - inptrB[i];
-                    break;
-                case 2:
-                    r = inptrA[i] * inptrB[i];
-                    break;
-                case 3:
-                    if (inptrB[i] == 0 || (inptrB[i] == -1 && inptrA[i] == CL_SHRT_MIN))
-                        continue;
-                    else
-                        r = inptrA[i] / inptrB[i];
-                    break;
-                case 4:
-                    if (inptrB[i] == 0 || (inptrB[i] == -1 && inptrA[i] == CL_SHRT_MIN))
-                        continue;
-                    else
-                        r = inptrA[i] % inptrB[i];
-                    break;
-                case 5:
-                    r = inptrA[i] & inptrB[i];
-                    break;
-                case 6:
-                    r = inptrA[i] | inptrB[i];
-                    break;
-                case 7:
-                    r = inptrA[i] ^ inptrB[i];
-                    break;
-                case 8:
-                    r = inptrA[i] >> (inptrB[i] & shift_mask);
-                    break;
-                case 9:
-                    r = inptrA[i] << (inptrB[i] & shift_mask);
-                    break;
-                case 10:
-                    r = inptrA[i] >> (inptrB[j] & shift_mask);
-                    break;
-                case 11:
-                    r = inptrA[i] << (inptrB[j] & shift_mask);
-                    break;
-                case 12:
-                    r = ~inptrA[i];
-                    break;
-                case 13:
-                    r = (inptrA[j] < inptrB[j]) ? inptrA[i] : inptrB[i];
-                    break;
-                case 14:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] && inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 15:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] || inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 16:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] < inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 17:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] > inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 18:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] <= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 19:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] >= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 20:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] == inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 21:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] != inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 22:
-                    // Scalars are set to 1/0
-                    r = !inptrA[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                default:
-                    log_error("Invalid test: %d\n", test);
-                    return -1;
-                    break;
-            }
-            if (r != outptr[i]) {
-                // Shift is tricky
-                if (test == 8 || test == 9) {
-                    log_error("cl_short Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                    log_error("\t1) Shift failure at element %zu: original is "
-                              "0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[i],
-                              inptrB[i]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_short)*8),  inptrB[i]&shift_mask, inptrB[i]&shift_mask);
-                }
-                else if (test == 10 || test == 11) {
-                    log_error("cl_short Verification failed at element %zu "
-                              "(%zu): 0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, j, inptrA[i], tests[test], inptrB[j], r,
-                              outptr[i]);
-                    log_error("\t1) Scalar shift failure at element %zu: "
-                              "original is 0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[j],
-                              inptrB[j]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_short)*8),  inptrB[j]&shift_mask, inptrB[j]&shift_mask);
-                } else if (test == 13) {
-                    log_error(
-                        "cl_int Verification failed at element %zu (%zu): "
-                        "(0x%x < 0x%x) ? 0x%x : 0x%x = 0x%x, got 0x%x\n",
-                        i, j, inptrA[j], inptrB[j], inptrA[i], inptrB[i], r,
-                        outptr[i]);
-                } else {
-                    log_error("cl_short Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                }
-                count++;
-                if (count >= MAX_ERRORS_TO_PRINT) {
-                    log_error("Further errors ignored.\n");
-                    return -1;
-                }
-            }
-        }
-    }
-
-    if (count) return -1; else return 0;
+    return verify_integer("cl_short", test, vector_size, inptrA, inptrB, outptr,
+                          n);
 }
 
 void
@@ -1181,190 +520,11 @@ init_short_data(uint64_t indx, int num_elements, cl_short *input_ptr[], MTdata d
 // =======================================
 // ushort
 // =======================================
-int
-verify_ushort(int test, size_t vector_size, cl_ushort *inptrA, cl_ushort *inptrB, cl_ushort *outptr, size_t n)
+int verify_ushort(int test, size_t vector_size, cl_ushort *inptrA,
+                  cl_ushort *inptrB, cl_ushort *outptr, size_t n)
 {
-    cl_ushort       r;
-    cl_uint   shift_mask = vector_size == 1 ? (cl_uint)(sizeof(cl_uint)*8)-1
-    : (cl_uint)(sizeof(cl_ushort)*8)-1;
-    size_t          i, j;
-    int             count=0;
-
-    for (j=0; j<n; j += vector_size )
-    {
-        for( i = j; i < j + vector_size; i++ )
-        {
-            switch (test) {
-                case 0:
-                    r = inptrA[i] + inptrB[i];
-                    break;
-                case 1:
-                    r = inptrA[i] - inptrB[i];
-                    break;
-                case 2:
-                    r = inptrA[i] * inptrB[i];
-                    break;
-                case 3:
-                    if (inptrB[i] == 0)
-                        continue;
-                    else
-                        r = inptrA[i] / inptrB[i];
-                    break;
-                case 4:
-                    if (inptrB[i] == 0)
-                        continue;
-                    else
-                        r = inptrA[i] % inptrB[i];
-                    break;
-                case 5:
-                    r = inptrA[i] & inptrB[i];
-                    break;
-                case 6:
-                    r = inptrA[i] | inptrB[i];
-                    break;
-                case 7:
-                    r = inptrA[i] ^ inptrB[i];
-                    break;
-                case 8:
-                    r = inptrA[i] >> (inptrB[i] & shift_mask);
-                    break;
-                case 9:
-                    r = inptrA[i] << (inptrB[i] & shift_mask);
-                    break;
-                case 10:
-                    r = inptrA[i] >> (inptrB[j] & shift_mask);
-                    break;
-                case 11:
-                    r = inptrA[i] << (inptrB[j] & shift_mask);
-                    break;
-                case 12:
-                    r = ~inptrA[i];
-                    break;
-                case 13:
-                    r = (inptrA[j] < inptrB[j]) ? inptrA[i] : inptrB[i];
-                    break;
-                case 14:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] && inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 15:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] || inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 16:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] < inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 17:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] > inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 18:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] <= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 19:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] >= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 20:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] == inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 21:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] != inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 22:
-                    // Scalars are set to 1/0
-                    r = !inptrA[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                default:
-                    log_error("Invalid test: %d\n", test);
-                    return -1;
-                    break;
-            }
-            if (r != outptr[i]) {
-                // Shift is tricky
-                if (test == 8 || test == 9) {
-                    log_error("cl_ushort Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                    log_error("\t1) Shift failure at element %zu: original is "
-                              "0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[i],
-                              inptrB[i]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_ushort)*8),  inptrB[i]&shift_mask, inptrB[i]&shift_mask);
-                }
-                else if (test == 10 || test == 11) {
-                    log_error("cl_ushort Verification failed at element %zu "
-                              "(%zu): 0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, j, inptrA[i], tests[test], inptrB[j], r,
-                              outptr[i]);
-                    log_error("\t1) Scalar shift failure at element %zu: "
-                              "original is 0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[j],
-                              inptrB[j]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_ushort)*8),  inptrB[j]&shift_mask, inptrB[j]&shift_mask);
-                } else if (test == 13) {
-                    log_error(
-                        "cl_int Verification failed at element %zu (%zu): "
-                        "(0x%x < 0x%x) ? 0x%x : 0x%x = 0x%x, got 0x%x\n",
-                        i, j, inptrA[j], inptrB[j], inptrA[i], inptrB[i], r,
-                        outptr[i]);
-                } else {
-                    log_error("cl_ushort Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                }
-                count++;
-                if (count >= MAX_ERRORS_TO_PRINT) {
-                    log_error("Further errors ignored.\n");
-                    return -1;
-                }
-            }
-        }
-    }
-
-    if (count) return -1; else return 0;
+    return verify_integer("cl_ushort", test, vector_size, inptrA, inptrB,
+                          outptr, n);
 }
 
 void
@@ -1398,190 +558,11 @@ init_ushort_data(uint64_t indx, int num_elements, cl_ushort *input_ptr[], MTdata
 // =======================================
 // char
 // =======================================
-int
-verify_char(int test, size_t vector_size, cl_char *inptrA, cl_char *inptrB, cl_char *outptr, size_t n)
+int verify_char(int test, size_t vector_size, cl_char *inptrA, cl_char *inptrB,
+                cl_char *outptr, size_t n)
 {
-    cl_char   r;
-    cl_int    shift_mask = vector_size == 1 ? (cl_int)(sizeof(cl_int)*8)-1
-    : (cl_int)(sizeof(cl_char)*8)-1;
-    size_t    i, j;
-    int       count=0;
-
-    for (j=0; j<n; j += vector_size )
-    {
-        for( i = j; i < j + vector_size; i++ )
-        {
-
-            switch (test) {
-                case 0:
-                    r = inptrA[i] + inptrB[i];
-                    break;
-                case 1:
-                    r = inptrA[i] - inptrB[i];
-                    break;
-                case 2:
-                    r = inptrA[i] * inptrB[i];
-                    break;
-                case 3:
-                    if (inptrB[i] == 0 || (inptrB[i] == -1 && inptrA[i] == CL_CHAR_MIN))
-                        continue;
-                    else
-                        r = inptrA[i] / inptrB[i];
-                    break;
-                case 4:
-                    if (inptrB[i] == 0 || (inptrB[i] == -1 && inptrA[i] == CL_CHAR_MIN))
-                        continue;
-                    else
-                        r = inptrA[i] % inptrB[i];
-                    break;
-                case 5:
-                    r = inptrA[i] & inptrB[i];
-                    break;
-                case 6:
-                    r = inptrA[i] | inptrB[i];
-                    break;
-                case 7:
-                    r = inptrA[i] ^ inptrB[i];
-                    break;
-                case 8:
-                    r = inptrA[i] >> (inptrB[i] & shift_mask);
-                    break;
-                case 9:
-                    r = inptrA[i] << (inptrB[i] & shift_mask);
-                    break;
-                case 10:
-                    r = inptrA[i] >> (inptrB[j] & shift_mask);
-                    break;
-                case 11:
-                    r = inptrA[i] << (inptrB[j] & shift_mask);
-                    break;
-                case 12:
-                    r = ~inptrA[i];
-                    break;
-                case 13:
-                    r = (inptrA[j] < inptrB[j]) ? inptrA[i] : inptrB[i];
-                    break;
-                case 14:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] && inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 15:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] || inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 16:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] < inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 17:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] > inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 18:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] <= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 19:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] >= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 20:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] == inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 21:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] != inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 22:
-                    // Scalars are set to 1/0
-                    r = !inptrA[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                default:
-                    log_error("Invalid test: %d\n", test);
-                    return -1;
-                    break;
-            }
-            if (r != outptr[i]) {
-                // Shift is tricky
-                if (test == 8 || test == 9) {
-                    log_error("cl_char Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                    log_error("\t1) Shift failure at element %zu: original is "
-                              "0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[i],
-                              inptrB[i]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_char)*8),  inptrB[i]&shift_mask, inptrB[i]&shift_mask);
-                }
-                else if (test == 10 || test == 11) {
-                    log_error("cl_char Verification failed at element %zu "
-                              "(%zu): 0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, j, inptrA[i], tests[test], inptrB[j], r,
-                              outptr[i]);
-                    log_error("\t1) Scalar shift failure at element %zu: "
-                              "original is 0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[j],
-                              inptrB[j]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_long)*8),  inptrB[j]&shift_mask, inptrB[j]&shift_mask);
-                } else if (test == 13) {
-                    log_error(
-                        "cl_int Verification failed at element %zu (%zu): "
-                        "(0x%x < 0x%x) ? 0x%x : 0x%x = 0x%x, got 0x%x\n",
-                        i, j, inptrA[j], inptrB[j], inptrA[i], inptrB[i], r,
-                        outptr[i]);
-                } else {
-                    log_error("cl_char Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                }
-                count++;
-                if (count >= MAX_ERRORS_TO_PRINT) {
-                    log_error("Further errors ignored.\n");
-                    return -1;
-                }
-            }
-        }
-    }
-    if (count) return -1; else return 0;
+    return verify_integer("cl_char", test, vector_size, inptrA, inptrB, outptr,
+                          n);
 }
 
 void
@@ -1623,190 +604,11 @@ init_char_data(uint64_t indx, int num_elements, cl_char *input_ptr[], MTdata d)
 // =======================================
 // uchar
 // =======================================
-int
-verify_uchar(int test, size_t vector_size, cl_uchar *inptrA, cl_uchar *inptrB, cl_uchar *outptr, size_t n)
+int verify_uchar(int test, size_t vector_size, cl_uchar *inptrA,
+                 cl_uchar *inptrB, cl_uchar *outptr, size_t n)
 {
-    cl_uchar r;
-    cl_uint shift_mask = vector_size == 1 ? (cl_uint)(sizeof(cl_uint) * 8) - 1
-                                          : (cl_uint)(sizeof(cl_uchar) * 8) - 1;
-    size_t   i, j;
-    int      count=0;
-
-    for (j=0; j<n; j += vector_size )
-    {
-        for( i = j; i < j + vector_size; i++ )
-        {
-            switch (test) {
-                case 0:
-                    r = inptrA[i] + inptrB[i];
-                    break;
-                case 1:
-                    r = inptrA[i] - inptrB[i];
-                    break;
-                case 2:
-                    r = inptrA[i] * inptrB[i];
-                    break;
-                case 3:
-                    if (inptrB[i] == 0)
-                        continue;
-                    else
-                        r = inptrA[i] / inptrB[i];
-                    break;
-                case 4:
-                    if (inptrB[i] == 0)
-                        continue;
-                    else
-                        r = inptrA[i] % inptrB[i];
-                    break;
-                case 5:
-                    r = inptrA[i] & inptrB[i];
-                    break;
-                case 6:
-                    r = inptrA[i] | inptrB[i];
-                    break;
-                case 7:
-                    r = inptrA[i] ^ inptrB[i];
-                    break;
-                case 8:
-                    r = inptrA[i] >> (inptrB[i] & shift_mask);
-                    break;
-                case 9:
-                    r = inptrA[i] << (inptrB[i] & shift_mask);
-                    break;
-                case 10:
-                    r = inptrA[i] >> (inptrB[j] & shift_mask);
-                    break;
-                case 11:
-                    r = inptrA[i] << (inptrB[j] & shift_mask);
-                    break;
-                case 12:
-                    r = ~inptrA[i];
-                    break;
-                case 13:
-                    r = (inptrA[j] < inptrB[j]) ? inptrA[i] : inptrB[i];
-                    break;
-                case 14:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] && inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 15:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] || inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 16:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] < inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 17:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] > inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 18:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] <= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 19:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] >= inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 20:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] == inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 21:
-                    // Scalars are set to 1/0
-                    r = inptrA[i] != inptrB[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                case 22:
-                    // Scalars are set to 1/0
-                    r = !inptrA[i];
-                    // Vectors are set to -1/0
-                    if (vector_size != 1 && r) {
-                        r = -1;
-                    }
-                    break;
-                default:
-                    log_error("Invalid test: %d\n", test);
-                    return -1;
-                    break;
-            }
-            if (r != outptr[i]) {
-                // Shift is tricky
-                if (test == 8 || test == 9) {
-                    log_error("cl_uchar Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                    log_error("\t1) Shift failure at element %zu: original is "
-                              "0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[i],
-                              inptrB[i]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_uchar)*8),  inptrB[i]&shift_mask, inptrB[i]&shift_mask);
-                }
-                else if (test == 10 || test == 11) {
-                    log_error("cl_uchar Verification failed at element %zu "
-                              "(%zu): 0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, j, inptrA[i], tests[test], inptrB[j], r,
-                              outptr[i]);
-                    log_error("\t1) Scalar shift failure at element %zu: "
-                              "original is 0x%x %s %d (0x%x)\n",
-                              i, inptrA[i], tests[test], (int)inptrB[j],
-                              inptrB[j]);
-                    log_error("\t2) Take the %d LSBs of the shift to get the final shift amount %d (0x%x).\n", (int)log2(sizeof(cl_uchar)*8),  inptrB[j]&shift_mask, inptrB[j]&shift_mask);
-                } else if (test == 13) {
-                    log_error(
-                        "cl_int Verification failed at element %zu (%zu): "
-                        "(0x%x < 0x%x) ? 0x%x : 0x%x = 0x%x, got 0x%x\n",
-                        i, j, inptrA[j], inptrB[j], inptrA[i], inptrB[i], r,
-                        outptr[i]);
-                } else {
-                    log_error("cl_uchar Verification failed at element %zu: "
-                              "0x%x %s 0x%x = 0x%x, got 0x%x\n",
-                              i, inptrA[i], tests[test], inptrB[i], r,
-                              outptr[i]);
-                }
-                count++;
-                if (count >= MAX_ERRORS_TO_PRINT) {
-                    log_error("Further errors ignored.\n");
-                    return -1;
-                }
-            }
-        }
-    }
-
-    if (count) return -1; else return 0;
+    return verify_integer("cl_uchar", test, vector_size, inptrA, inptrB, outptr,
+                          n);
 }
 
 void
@@ -110,7 +110,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     int isNextafter = job->isNextafter;
     cl_ushort *t;
     cl_half *r;
-    std::vector<float> s(0), s2(0);
+    std::vector<float> s(0), s2(0), ref(0);
     cl_uint j = 0;
 
     RoundingMode oldRoundMode;
@@ -281,16 +281,17 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     t = (cl_ushort *)r;
     s.resize(buffer_elements);
     s2.resize(buffer_elements);
+    ref.resize(buffer_elements);
+    convert_halves_to_floats(s.data(), p, buffer_elements);
+    convert_halves_to_floats(s2.data(), p2, buffer_elements);
     for (j = 0; j < buffer_elements; j++)
     {
-        s[j] = cl_half_to_float(p[j]);
-        s2[j] = cl_half_to_float(p2[j]);
         if (isNextafter)
-            r[j] = cl_half_from_float(reference_nextafterh(s[j], s2[j]),
-                                      halfRoundingMode);
+            ref[j] = reference_nextafterh(s[j], s2[j]);
         else
-            r[j] = cl_half_from_float(ref_func(s[j], s2[j]), halfRoundingMode);
+            ref[j] = ref_func(s[j], s2[j]);
     }
+    convert_floats_to_halves(r, ref.data(), buffer_elements, halfRoundingMode);
 
     if (isFDim && ftz) RestoreFPState(&oldMode);
     // Read the data back -- no need to wait for the first N-1 buffers. This is
@@ -107,7 +107,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     const char *name = job->f->name;
     cl_ushort *t;
     cl_half *r;
-    std::vector<float> s;
+    std::vector<float> s, ref;
     cl_int *s2;
 
     // start the map of the output arrays
@@ -252,12 +252,11 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     r = (cl_half *)gOut_Ref + thread_id * buffer_elements;
     t = (cl_ushort *)r;
     s.resize(buffer_elements);
+    ref.resize(buffer_elements);
     s2 = (cl_int *)gIn2 + thread_id * buffer_elements;
-    for (j = 0; j < buffer_elements; j++)
-    {
-        s[j] = cl_half_to_float(p[j]);
-        r[j] = HFF(func.f_fi(s[j], s2[j]));
-    }
+    convert_halves_to_floats(s.data(), p, buffer_elements);
+    for (j = 0; j < buffer_elements; j++) ref[j] = func.f_fi(s[j], s2[j]);
+    convert_floats_to_halves(r, ref.data(), buffer_elements, gHalfRoundingMode);
 
     // Read the data back -- no need to wait for the first N-1 buffers. This is
     // an in order queue.
@@ -117,7 +117,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
 
     const char *name = job->f->name;
     cl_half *r = 0;
-    std::vector<float> s(0), s2(0);
+    std::vector<float> s(0), s2(0), ref(0);
     RoundingMode oldRoundMode;
 
     cl_event e[VECTOR_SIZE_COUNT];
@@ -271,13 +271,13 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     r = (cl_half *)gOut_Ref + thread_id * buffer_elements;
     s.resize(buffer_elements);
     s2.resize(buffer_elements);
+    ref.resize(buffer_elements);
 
+    convert_halves_to_floats(s.data(), p, buffer_elements);
+    convert_halves_to_floats(s2.data(), p2, buffer_elements);
     for (size_t j = 0; j < buffer_elements; j++)
-    {
-        s[j] = HTF(p[j]);
-        s2[j] = HTF(p2[j]);
-        r[j] = HFF(func.f_ff(s[j], s2[j]));
-    }
+        ref[j] = func.f_ff(s[j], s2[j]);
+    convert_floats_to_halves(r, ref.data(), buffer_elements, gHalfRoundingMode);
 
     if (ftz) RestoreFPState(&oldMode);
 
@@ -139,11 +139,8 @@ int TestFunc_Int_Half(const Func *f, MTdata d, bool relaxedMode)
 
         // Calculate the correctly rounded reference result
         int *r = (int *)gOut_Ref;
-        for (size_t j = 0; j < bufferElements; j++)
-        {
-            s[j] = HTF(p[j]);
-            r[j] = f->func.i_f(s[j]);
-        }
+        convert_halves_to_floats(s.data(), p, bufferElements);
+        for (size_t j = 0; j < bufferElements; j++) r[j] = f->func.i_f(s[j]);
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
@@ -238,12 +238,9 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     t = (cl_short *)r;
     s.resize(buffer_elements);
     s2.resize(buffer_elements);
-    for (j = 0; j < buffer_elements; j++)
-    {
-        s[j] = cl_half_to_float(p[j]);
-        s2[j] = cl_half_to_float(p2[j]);
-        r[j] = (short)func.i_ff(s[j], s2[j]);
-    }
+    convert_halves_to_floats(s.data(), p, buffer_elements);
+    convert_halves_to_floats(s2.data(), p2, buffer_elements);
+    for (j = 0; j < buffer_elements; j++) r[j] = (short)func.i_ff(s[j], s2[j]);
 
     // Read the data back -- no need to wait for the first N-1 buffers. This is
     // an in order queue.
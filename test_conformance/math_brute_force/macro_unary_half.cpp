@@ -176,9 +176,9 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     cl_short *r = (cl_short *)gOut_Ref + thread_id * buffer_elements;
     cl_short *t = (cl_short *)r;
     s.resize(buffer_elements);
+    convert_halves_to_floats(s.data(), p, buffer_elements);
     for (j = 0; j < buffer_elements; j++)
     {
-        s[j] = cl_half_to_float(p[j]);
         if (!strcmp(name, "isnormal"))
         {
             if ((IsHalfSubnormal(p[j]) == 0) && !((p[j] & 0x7fffU) >= 0x7c00U)
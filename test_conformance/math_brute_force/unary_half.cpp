@@ -80,7 +80,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     float half_sin_cos_tan_limit = job->half_sin_cos_tan_limit;
     int ftz = job->ftz;
 
-    std::vector<float> s(0);
+    std::vector<float> s(0), ref(0);
 
     cl_event e[VECTOR_SIZE_COUNT];
     cl_ushort *out[VECTOR_SIZE_COUNT];
@@ -183,11 +183,10 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     // Calculate the correctly rounded reference result
     cl_half *r = (cl_half *)gOut_Ref + thread_id * buffer_elements;
     s.resize(buffer_elements);
-    for (j = 0; j < buffer_elements; j++)
-    {
-        s[j] = (float)cl_half_to_float(p[j]);
-        r[j] = HFF(func.f_f(s[j]));
-    }
+    ref.resize(buffer_elements);
+    convert_halves_to_floats(s.data(), p, buffer_elements);
+    for (j = 0; j < buffer_elements; j++) ref[j] = func.f_f(s[j]);
+    convert_floats_to_halves(r, ref.data(), buffer_elements, gHalfRoundingMode);
 
     // Read the data back -- no need to wait for the first N-1 buffers. This is
     // an in order queue.
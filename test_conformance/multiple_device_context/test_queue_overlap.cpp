@@ -0,0 +1,505 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/benchmarkHelpers.h"
+#include "harness/typeWrappers.h"
+
+#include <CL/cl_ext.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char *overlap_source =
+    "__kernel void overlap_compute(__global uint *out, uint iterations)\n"
+    "{\n"
+    "    uint x = (uint)get_global_id(0);\n"
+    "    for (uint i = 0; i < iterations; i++)\n"
+    "        x = x * 1664525u + 1013904223u;\n"
+    "    out[get_global_id(0)] = x;\n"
+    "}\n";
+
+enum OpKind
+{
+    kOpCompute,
+    kOpWrite,
+    kOpRead,
+    kNumOpKinds
+};
+
+const char *op_kind_names[kNumOpKinds] = { "compute", "write", "read" };
+
+// Operations that run at the same time, each on the queue with the given
+// index. Two computes write to different outputs.
+struct Scenario
+{
+    const char *name;
+    int numOps;
+    OpKind ops[3];
+    int queues[3];
+};
+
+const Scenario overlap_scenarios[] = {
+    // Both on one in-order queue, which has to run them one after the other
+    { "same_queue_compute+write", 2, { kOpCompute, kOpWrite }, { 0, 0 } },
+    { "compute+write", 2, { kOpCompute, kOpWrite }, { 0, 1 } },
+    { "compute+read", 2, { kOpCompute, kOpRead }, { 0, 1 } },
+    { "write+read", 2, { kOpWrite, kOpRead }, { 0, 1 } },
+    { "compute+write+read",
+      3,
+      { kOpCompute, kOpWrite, kOpRead },
+      { 0, 1, 2 } },
+    { "compute+compute", 2, { kOpCompute, kOpCompute }, { 0, 1 } },
+};
+
+const int kOverlapQueues = 3;
+
+// Every operation is sized to take about this long on its own
+const double kTargetMs = 50.0;
+
+// Each scenario runs this many times, unless --benchmark-samples says
+// otherwise, and the best run is reported
+const int kOverlapRepeats = 3;
+
+const size_t kComputeGlobalSize = 1 << 20;
+const size_t kMaxTransferSize = 512 * 1024 * 1024;
+
+cl_uint expected_compute(cl_uint x, cl_uint iterations)
+{
+    for (cl_uint i = 0; i < iterations; i++) x = x * 1664525U + 1013904223U;
+    return x;
+}
+
+struct EventInterval
+{
+    cl_ulong start;
+    cl_ulong end;
+};
+
+int get_interval(cl_event event, EventInterval &t)
+{
+    int error = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START,
+                                        sizeof(t.start), &t.start, NULL);
+    error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,
+                                     sizeof(t.end), &t.end, NULL);
+    test_error(error, "clGetEventProfilingInfo failed");
+    return CL_SUCCESS;
+}
+
+struct OverlapResources
+{
+    cl_kernel kernel;
+    cl_uint iterations;
+    clMemWrapper computeOut[2];
+    size_t transferSize;
+    clMemWrapper writeDst; // written from hostSrc
+    clMemWrapper readSrc; // read into hostDst
+    clMemWrapper hostSrcBuffer;
+    clMemWrapper hostDstBuffer;
+    cl_uchar *hostSrc;
+    cl_uchar *hostDst;
+};
+
+int enqueue_op(OverlapResources &r, OpKind kind, int slot,
+               cl_command_queue queue, cl_event *event)
+{
+    int error;
+    switch (kind)
+    {
+        case kOpCompute:
+            error = clSetKernelArg(r.kernel, 0, sizeof(cl_mem),
+                                   &r.computeOut[slot]);
+            error |= clSetKernelArg(r.kernel, 1, sizeof(r.iterations),
+                                    &r.iterations);
+            test_error(error, "Unable to set kernel arguments");
+            error = clEnqueueNDRangeKernel(queue, r.kernel, 1, NULL,
+                                           &kComputeGlobalSize, NULL, 0, NULL,
+                                           event);
+            test_error(error, "clEnqueueNDRangeKernel failed");
+            break;
+        case kOpWrite:
+            error = clEnqueueWriteBuffer(queue, r.writeDst, CL_FALSE, 0,
+                                         r.transferSize, r.hostSrc, 0, NULL,
+                                         event);
+            test_error(error, "clEnqueueWriteBuffer failed");
+            break;
+        case kOpRead:
+            error = clEnqueueReadBuffer(queue, r.readSrc, CL_FALSE, 0,
+                                        r.transferSize, r.hostDst, 0, NULL,
+                                        event);
+            test_error(error, "clEnqueueReadBuffer failed");
+            break;
+        default: break;
+    }
+    return CL_SUCCESS;
+}
+
+// Runs one operation alone and returns its device time in ns, or 0 on failure
+cl_ulong time_op(OverlapResources &r, OpKind kind, cl_command_queue queue)
+{
+    clEventWrapper event;
+    if (enqueue_op(r, kind, 0, queue, &event)) return 0;
+    EventInterval t;
+    if (clFinish(queue) || get_interval(event, t)) return 0;
+    return t.end - t.start;
+}
+
+// Scales the compute iterations and the transfer size so that each takes
+// about kTargetMs alone.
+int calibrate(OverlapResources &r, cl_command_queue queue, size_t maxTransfer)
+{
+    r.iterations = 256;
+    r.transferSize = std::min((size_t)16 * 1024 * 1024, maxTransfer);
+    for (int step = 0; step < 3; step++)
+    {
+        cl_ulong computeNs = time_op(r, kOpCompute, queue);
+        cl_ulong writeNs = time_op(r, kOpWrite, queue);
+        if (!computeNs || !writeNs) return -1;
+        double computeScale = kTargetMs * 1e6 / computeNs;
+        double writeScale = kTargetMs * 1e6 / writeNs;
+        r.iterations = (cl_uint)std::min(
+            std::max(r.iterations * computeScale, 1.0), 1e7);
+        double size = std::min(r.transferSize * writeScale,
+                               (double)maxTransfer);
+        r.transferSize = std::max((size_t)size / 4096 * 4096, (size_t)4096);
+    }
+    return CL_SUCCESS;
+}
+
+// Zeroes everything a scenario writes, including the host side of the read,
+// so that verify only passes on results of the scenario itself
+int clear_outputs(OverlapResources &r, cl_command_queue queue)
+{
+    const cl_uint zero = 0;
+    int error = CL_SUCCESS;
+    for (int s = 0; s < 2; s++)
+        error |= clEnqueueFillBuffer(queue, r.computeOut[s], &zero,
+                                     sizeof(zero), 0,
+                                     kComputeGlobalSize * sizeof(cl_uint), 0,
+                                     NULL, NULL);
+    error |= clEnqueueFillBuffer(queue, r.writeDst, &zero, sizeof(zero), 0,
+                                 r.transferSize, 0, NULL, NULL);
+    test_error(error, "Unable to clear scenario outputs");
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    memset(r.hostDst, 0, r.transferSize);
+    return CL_SUCCESS;
+}
+
+int verify(OverlapResources &r, cl_command_queue queue,
+           const Scenario &scenario)
+{
+    int error;
+    int computeSlot = 0;
+    for (int o = 0; o < scenario.numOps; o++)
+    {
+        if (scenario.ops[o] == kOpCompute)
+        {
+            std::vector<cl_uint> out(kComputeGlobalSize);
+            error = clEnqueueReadBuffer(
+                queue, r.computeOut[computeSlot++], CL_TRUE, 0,
+                out.size() * sizeof(cl_uint), out.data(), 0, NULL, NULL);
+            test_error(error, "Unable to read compute results");
+            for (size_t i = 0; i < out.size(); i += 65521)
+            {
+                cl_uint expected = expected_compute((cl_uint)i, r.iterations);
+                if (out[i] != expected)
+                {
+                    log_error("ERROR: %s: compute result %zu is %u, expected "
+                              "%u\n",
+                              scenario.name, i, out[i], expected);
+                    return -1;
+                }
+            }
+        }
+        else if (scenario.ops[o] == kOpWrite)
+        {
+            std::vector<cl_uchar> written(r.transferSize);
+            error = clEnqueueReadBuffer(queue, r.writeDst, CL_TRUE, 0,
+                                        r.transferSize, written.data(), 0,
+                                        NULL, NULL);
+            test_error(error, "Unable to read written buffer");
+            if (memcmp(written.data(), r.hostSrc, r.transferSize))
+            {
+                log_error("ERROR: %s: the write transfer did not copy the "
+                          "host data\n",
+                          scenario.name);
+                return -1;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < r.transferSize; i++)
+            {
+                if (r.hostDst[i] != (cl_uchar)(i * 7 + 3))
+                {
+                    log_error("ERROR: %s: byte %zu of the read transfer is "
+                              "%u, expected %u\n",
+                              scenario.name, i, r.hostDst[i],
+                              (cl_uchar)(i * 7 + 3));
+                    return -1;
+                }
+            }
+        }
+    }
+    return CL_SUCCESS;
+}
+
+// Enqueues every operation of the scenario before flushing the queues, so
+// they are all available to the device at once. The overlap is 0 when the
+// operations ran one after the other and 1 when they all ran inside the
+// longest one.
+int run_scenario(OverlapResources &r, cl_command_queue *queues,
+                 const Scenario &scenario, const cl_ulong *aloneNs)
+{
+    int error = clear_outputs(r, queues[0]);
+    if (error) return error;
+
+    double bestSpeedup = 0, bestOverlap = 0, bestSpanMs = 0;
+    for (int rep = 0; rep < benchmark_samples(kOverlapRepeats); rep++)
+    {
+        clEventWrapper events[3];
+        int computeSlot = 0;
+        for (int o = 0; o < scenario.numOps; o++)
+        {
+            OpKind kind = scenario.ops[o];
+            int error =
+                enqueue_op(r, kind, kind == kOpCompute ? computeSlot++ : 0,
+                           queues[scenario.queues[o]], &events[o]);
+            if (error) return error;
+        }
+        for (int q = 0; q < kOverlapQueues; q++)
+        {
+            int error = clFlush(queues[q]);
+            test_error(error, "clFlush failed");
+        }
+        for (int q = 0; q < kOverlapQueues; q++)
+        {
+            int error = clFinish(queues[q]);
+            test_error(error, "clFinish failed");
+        }
+
+        cl_ulong first = CL_ULONG_MAX, last = 0, sum = 0, longest = 0,
+                 serial = 0;
+        for (int o = 0; o < scenario.numOps; o++)
+        {
+            EventInterval t;
+            int error = get_interval(events[o], t);
+            if (error) return error;
+            first = std::min(first, t.start);
+            last = std::max(last, t.end);
+            sum += t.end - t.start;
+            longest = std::max(longest, t.end - t.start);
+            serial += aloneNs[scenario.ops[o]];
+        }
+        double span = (double)(last - first);
+        double overlap = sum > longest ? (sum - span) / (sum - longest) : 0;
+        overlap = std::max(0.0, std::min(1.0, overlap));
+        if (serial / span > bestSpeedup)
+        {
+            bestSpeedup = serial / span;
+            bestOverlap = overlap;
+            bestSpanMs = span * 1e-6;
+        }
+    }
+
+    error = verify(r, queues[0], scenario);
+    if (error) return error;
+    log_info("OVERLAP %s serial_ms %.2f span_ms %.2f concurrency %.2f "
+             "overlap %.2f\n",
+             scenario.name, bestSpeedup * bestSpanMs, bestSpanMs,
+             bestSpeedup, bestOverlap);
+    return CL_SUCCESS;
+}
+
+// A long compute on a low priority queue, then the same compute on a high
+// priority queue. A scheduler that honours priorities finishes the high
+// priority one first.
+int run_priorities(cl_context context, cl_device_id device,
+                   OverlapResources &r)
+{
+    cl_queue_properties low[] = { CL_QUEUE_PROPERTIES,
+                                  CL_QUEUE_PROFILING_ENABLE,
+                                  CL_QUEUE_PRIORITY_KHR,
+                                  CL_QUEUE_PRIORITY_LOW_KHR, 0 };
+    cl_queue_properties high[] = { CL_QUEUE_PROPERTIES,
+                                   CL_QUEUE_PROFILING_ENABLE,
+                                   CL_QUEUE_PRIORITY_KHR,
+                                   CL_QUEUE_PRIORITY_HIGH_KHR, 0 };
+    int error;
+    clCommandQueueWrapper lowQueue =
+        clCreateCommandQueueWithProperties(context, device, low, &error);
+    test_error(error, "Unable to create low priority queue");
+    clCommandQueueWrapper highQueue =
+        clCreateCommandQueueWithProperties(context, device, high, &error);
+    test_error(error, "Unable to create high priority queue");
+
+    error = clear_outputs(r, lowQueue);
+    if (error) return error;
+
+    clEventWrapper lowEvent, highEvent;
+    error = enqueue_op(r, kOpCompute, 0, lowQueue, &lowEvent);
+    if (error) return error;
+    error = clFlush(lowQueue);
+    test_error(error, "clFlush failed");
+    error = enqueue_op(r, kOpCompute, 1, highQueue, &highEvent);
+    if (error) return error;
+    error = clFinish(highQueue);
+    test_error(error, "clFinish failed");
+    error = clFinish(lowQueue);
+    test_error(error, "clFinish failed");
+
+    EventInterval lowTime, highTime;
+    error = get_interval(lowEvent, lowTime);
+    if (error) return error;
+    error = get_interval(highEvent, highTime);
+    if (error) return error;
+    log_info("PRIORITY low_ms %.2f high_ms %.2f high_start_after_low_ms %.2f "
+             "high_finished_first %s\n",
+             (lowTime.end - lowTime.start) * 1e-6,
+             (highTime.end - highTime.start) * 1e-6,
+             ((double)highTime.start - lowTime.start) * 1e-6,
+             highTime.end < lowTime.end ? "yes" : "no");
+
+    const Scenario both = { "priority", 2, { kOpCompute, kOpCompute } };
+    return verify(r, lowQueue, both);
+}
+
+}
+
+REGISTER_TEST(queue_overlap)
+{
+    if (!gBenchmark)
+    {
+        log_info("Skipping, the queue overlap benchmark only runs with "
+                 "'--benchmark'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    int error;
+    clContextWrapper ownContext =
+        clCreateContext(NULL, 1, &device, NULL, NULL, &error);
+    test_error(error, "Unable to create context");
+    context = ownContext;
+
+    clCommandQueueWrapper ownQueues[kOverlapQueues];
+    cl_command_queue queues[kOverlapQueues];
+    for (int q = 0; q < kOverlapQueues; q++)
+    {
+        ownQueues[q] = clCreateCommandQueue(
+            context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+        test_error(error, "Unable to create queue");
+        queues[q] = ownQueues[q];
+    }
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        &overlap_source, "overlap_compute");
+    test_error(error, "Unable to create kernel");
+
+    cl_ulong maxAlloc, globalMem;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(maxAlloc), &maxAlloc, NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE,
+                             sizeof(globalMem), &globalMem, NULL);
+    test_error(error, "Unable to get device memory sizes");
+    const size_t maxTransfer = (size_t)std::min(
+        { (cl_ulong)kMaxTransferSize, maxAlloc, globalMem / 8 });
+
+    // The host side of the transfers is allocated by the implementation so
+    // that it can be used for DMA without staging copies.
+    OverlapResources r;
+    r.kernel = kernel;
+    for (int s = 0; s < 2; s++)
+    {
+        r.computeOut[s] =
+            clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                           kComputeGlobalSize * sizeof(cl_uint), NULL, &error);
+        test_error(error, "Unable to create compute output");
+    }
+    r.writeDst = clCreateBuffer(context, CL_MEM_READ_WRITE, maxTransfer, NULL,
+                                &error);
+    test_error(error, "Unable to create write destination");
+    r.readSrc = clCreateBuffer(context, CL_MEM_READ_WRITE, maxTransfer, NULL,
+                               &error);
+    test_error(error, "Unable to create read source");
+    r.hostSrcBuffer = clCreateBuffer(context, CL_MEM_ALLOC_HOST_PTR,
+                                     maxTransfer, NULL, &error);
+    test_error(error, "Unable to create host source");
+    r.hostDstBuffer = clCreateBuffer(context, CL_MEM_ALLOC_HOST_PTR,
+                                     maxTransfer, NULL, &error);
+    test_error(error, "Unable to create host destination");
+    r.hostSrc = (cl_uchar *)clEnqueueMapBuffer(
+        queues[0], r.hostSrcBuffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0,
+        maxTransfer, 0, NULL, NULL, &error);
+    test_error(error, "Unable to map host source");
+    r.hostDst = (cl_uchar *)clEnqueueMapBuffer(
+        queues[0], r.hostDstBuffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0,
+        maxTransfer, 0, NULL, NULL, &error);
+    test_error(error, "Unable to map host destination");
+
+    for (size_t i = 0; i < maxTransfer; i++)
+    {
+        r.hostSrc[i] = (cl_uchar)(i * 13 + 5);
+        r.hostDst[i] = (cl_uchar)(i * 7 + 3);
+    }
+    error = clEnqueueWriteBuffer(queues[0], r.readSrc, CL_TRUE, 0,
+                                 maxTransfer, r.hostDst, 0, NULL, NULL);
+    test_error(error, "Unable to initialize read source");
+
+    error = calibrate(r, queues[0], maxTransfer);
+    if (error) return error;
+    cl_ulong aloneNs[kNumOpKinds];
+    for (int k = 0; k < kNumOpKinds; k++)
+    {
+        aloneNs[k] = time_op(r, (OpKind)k, queues[0]);
+        if (!aloneNs[k]) return -1;
+        log_info("OVERLAP_ALONE %s ms %.2f\n", op_kind_names[k],
+                 aloneNs[k] * 1e-6);
+    }
+    log_info("Compute runs %u iterations over %zu work-items, transfers move "
+             "%zu bytes\n",
+             r.iterations, kComputeGlobalSize, r.transferSize);
+
+    for (const Scenario &scenario : overlap_scenarios)
+    {
+        error = run_scenario(r, queues, scenario, aloneNs);
+        if (error) return error;
+    }
+
+    if (is_extension_available(device, "cl_khr_priority_hints"))
+    {
+        error = run_priorities(context, device, r);
+        if (error) return error;
+    }
+    else
+    {
+        log_info("cl_khr_priority_hints is not supported, skipping the "
+                 "priority measurement\n");
+    }
+
+    error = clEnqueueUnmapMemObject(queues[0], r.hostSrcBuffer, r.hostSrc, 0,
+                                    NULL, NULL);
+    error |= clEnqueueUnmapMemObject(queues[0], r.hostDstBuffer, r.hostDst, 0,
+                                     NULL, NULL);
+    test_error(error, "Unable to unmap host memory");
+    error = clFinish(queues[0]);
+    test_error(error, "clFinish failed");
+    return 0;
+}
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2025 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "procs.h"
+#include "harness/benchmarkHelpers.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *emptyKernelCode = "__kernel void dispatch_empty(){}";
+
+// Global sizes of the empty kernel launches
+const size_t kLatencyGlobalSizes[] = { 1, 64, 4096, 1 << 18, 1 << 24 };
+
+// Launches measured per latency, unless --benchmark-samples says otherwise
+const int kLatencySamples = 1000;
+
+// Prints the percentiles of a set of latencies on one line, followed by a
+// histogram with one power of two bucket per line.
+void report_latency(const std::string &name, std::vector<cl_ulong> samples)
+{
+    if (samples.empty()) return;
+    std::sort(samples.begin(), samples.end());
+    log_info("LATENCY %s samples %zu us min %.2f p50 %.2f p90 %.2f p99 %.2f "
+             "p99.9 %.2f max %.2f\n",
+             name.c_str(), samples.size(), samples.front() * 1e-3,
+             sorted_percentile(samples, 50) * 1e-3,
+             sorted_percentile(samples, 90) * 1e-3,
+             sorted_percentile(samples, 99) * 1e-3,
+             sorted_percentile(samples, 99.9) * 1e-3, samples.back() * 1e-3);
+
+    std::vector<size_t> buckets(65);
+    for (cl_ulong ns : samples)
+    {
+        int bucket = 0;
+        while (bucket < 64 && (ns >> bucket) > 1) bucket++;
+        buckets[bucket]++;
+    }
+    size_t largest = *std::max_element(buckets.begin(), buckets.end());
+    for (int b = 0; b < 65; b++)
+    {
+        if (!buckets[b]) continue;
+        log_info("\t%12.2f us %8zu %s\n", (double)(1ULL << b) * 1e-3,
+                 buckets[b],
+                 std::string((buckets[b] * 50 + largest - 1) / largest, '#')
+                     .c_str());
+    }
+}
+
+struct EventTimes
+{
+    cl_ulong queued, submit, start, end;
+};
+
+int get_event_times(cl_event event, EventTimes &t)
+{
+    int error = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_QUEUED,
+                                        sizeof(t.queued), &t.queued, NULL);
+    error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_SUBMIT,
+                                     sizeof(t.submit), &t.submit, NULL);
+    error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START,
+                                     sizeof(t.start), &t.start, NULL);
+    error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,
+                                     sizeof(t.end), &t.end, NULL);
+    test_error(error, "clGetEventProfilingInfo failed");
+    return CL_SUCCESS;
+}
+
+// Enqueue-to-start and start-to-end of single empty kernels, one at a time
+int launch_latency(cl_device_id device, cl_command_queue queue,
+                   cl_kernel kernel, size_t globalSize)
+{
+    std::vector<cl_ulong> queuedToStart, startToEnd, roundTrip;
+    const int samples = benchmark_samples(kLatencySamples);
+    int error;
+    for (int i = 0; i <= samples; i++)
+    {
+        clEventWrapper event;
+        auto start = BenchmarkClock::now();
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize,
+                                       NULL, 0, NULL, &event);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        auto end = BenchmarkClock::now();
+
+        EventTimes t;
+        error = get_event_times(event, t);
+        if (error) return error;
+
+        // The first launch only warms up, but its times still have to be
+        // consistent
+        if (i == 0)
+        {
+            error = check_times(t.queued, t.submit, t.start, t.end, device);
+            if (error) return error;
+            continue;
+        }
+        if (t.queued > t.submit || t.submit > t.start || t.start > t.end)
+        {
+            log_error("ERROR: launch %d: QUEUED %" PRIu64 " SUBMIT %" PRIu64
+                      " START %" PRIu64 " END %" PRIu64 " out of order\n",
+                      i, t.queued, t.submit, t.start, t.end);
+            return -1;
+        }
+        queuedToStart.push_back(t.start - t.queued);
+        startToEnd.push_back(t.end - t.start);
+        roundTrip.push_back(host_elapsed_ns(start, end));
+    }
+
+    std::string suffix = "_global_" + std::to_string(globalSize);
+    report_latency("enqueue_to_start" + suffix, queuedToStart);
+    report_latency("start_to_end" + suffix, startToEnd);
+    report_latency("enqueue_finish_round_trip" + suffix, roundTrip);
+    return CL_SUCCESS;
+}
+
+// Back-to-back launches of a single work-item kernel, timed on the host from
+// the first enqueue to the return of clFinish
+int dispatch_throughput(cl_command_queue queue, cl_kernel kernel,
+                        bool withEvents)
+{
+    const size_t globalSize = 1;
+    const int samples = benchmark_samples(kLatencySamples);
+    std::vector<clEventWrapper> events(withEvents ? samples : 0);
+    std::vector<cl_ulong> enqueueCalls;
+    enqueueCalls.reserve(samples);
+    int error;
+
+    auto start = BenchmarkClock::now();
+    for (int i = 0; i < samples; i++)
+    {
+        auto before = BenchmarkClock::now();
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize,
+                                       NULL, 0, NULL,
+                                       withEvents ? &events[i] : NULL);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        enqueueCalls.push_back(
+            host_elapsed_ns(before, BenchmarkClock::now()));
+    }
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    cl_ulong total = host_elapsed_ns(start, BenchmarkClock::now());
+
+    const char *name = withEvents ? "with_events" : "without_events";
+    log_info("THROUGHPUT back_to_back_%s dispatches %d per_second %.0f\n",
+             name, samples, samples * 1e9 / total);
+    report_latency(std::string("enqueue_call_") + name, enqueueCalls);
+    return CL_SUCCESS;
+}
+
+// clFinish on a queue with nothing left to do
+int idle_finish_latency(cl_command_queue queue)
+{
+    std::vector<cl_ulong> samples;
+    int error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    for (int i = 0; i < benchmark_samples(kLatencySamples); i++)
+    {
+        auto start = BenchmarkClock::now();
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        samples.push_back(host_elapsed_ns(start, BenchmarkClock::now()));
+    }
+    report_latency("idle_finish", samples);
+    return CL_SUCCESS;
+}
+
+}
+
+REGISTER_TEST(dispatch_latency)
+{
+    if (!gBenchmark)
+    {
+        log_info("Skipping, the dispatch latency benchmark only runs with "
+                 "'--benchmark'\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    int error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                            &emptyKernelCode, "dispatch_empty");
+    test_error(error, "Failed to create kernel");
+
+    for (size_t globalSize : kLatencyGlobalSizes)
+    {
+        error = launch_latency(device, queue, kernel, globalSize);
+        if (error) return error;
+    }
+
+    error = dispatch_throughput(queue, kernel, false);
+    if (error) return error;
+    error = dispatch_throughput(queue, kernel, true);
+    if (error) return error;
+    return idle_finish_latency(queue);
+}